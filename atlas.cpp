@@ -0,0 +1,50 @@
+#include "atlas.h"
+#include "graphics.h"
+#include "rlgl.h"
+
+SpriteAtlas loadSpriteAtlas(int cellSize) {
+    SpriteAtlas atlas;
+    atlas.cellSize = cellSize;
+    atlas.pad      = 8;
+    atlas.slot     = cellSize + 2 * atlas.pad;
+    atlas.columns  = 8;
+    int rows = (SPRITE_COUNT + atlas.columns - 1) / atlas.columns;
+    atlas.target = LoadRenderTexture(atlas.columns * atlas.slot, rows * atlas.slot);
+
+    BeginTextureMode(atlas.target);
+    ClearBackground(BLANK);
+    // keep translucent shadows translucent instead of squaring their alpha;
+    // this leaves the atlas premultiplied, so it is drawn that way too
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                              RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+
+    const int noseDirs[4][2] = { { 1, 0 }, { -1, 0 }, { 0, -1 }, { 0, 1 } };
+    for (int sprite = 0; sprite < SPRITE_COUNT; sprite++) {
+        int x, y;
+        slotOrigin(atlas, sprite, x, y);
+        x += atlas.pad;
+        y += atlas.pad;
+
+        if (sprite <= SPRITE_LOCO_DOWN)
+            drawLocomotive(x, y, cellSize, noseDirs[sprite][0], noseDirs[sprite][1]);
+        else if (sprite == SPRITE_CARGO)
+            drawCargo(x, y, cellSize);
+        else if (sprite == SPRITE_WALL)
+            drawBrickWall(x, y, cellSize);
+        else if (sprite == SPRITE_PUFF)
+            DrawCircleGradient(x + cellSize / 2, y + cellSize / 2, cellSize * 0.5f, WHITE, Fade(WHITE, 0));
+        else if (sprite == SPRITE_CHIP)
+            DrawRectangle(x + 1, y + 1, cellSize - 2, cellSize - 2, WHITE);
+        else
+            drawCarriage(x, y, cellSize, (sprite - SPRITE_CARRIAGE) * (3.14159f / 2) / WHEEL_FRAMES);
+    }
+
+    EndBlendMode();
+    EndTextureMode();
+    return atlas;
+}
+
+void unloadSpriteAtlas(SpriteAtlas& atlas) {
+    UnloadRenderTexture(atlas.target);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "raylib.h"
+
+// Every per-cell sprite is rendered once into one texture, so the playfield
+// is drawn as textured quads that raylib batches into a single draw call.
+// Sprites are recorded into renderList (scene.h) and drawn at
+// submitRenderList().
+enum Sprite {
+    SPRITE_LOCO_RIGHT,
+    SPRITE_LOCO_LEFT,
+    SPRITE_LOCO_UP,
+    SPRITE_LOCO_DOWN,
+    SPRITE_CARGO,
+    SPRITE_WALL,
+    SPRITE_PUFF,                        // white, tinted per particle
+    SPRITE_CHIP,
+    SPRITE_CARRIAGE,                    // first of WHEEL_FRAMES wheel poses
+};
+
+const int WHEEL_FRAMES = 8;             // spokes repeat every quarter turn
+const int SPRITE_COUNT = SPRITE_CARRIAGE + WHEEL_FRAMES;
+
+struct SpriteAtlas {
+    RenderTexture2D target;
+    int cellSize;
+    int pad;                            // room for the nose and chimney
+    int slot;                           // cellSize + 2 * pad
+    int columns;
+};
+
+SpriteAtlas loadSpriteAtlas(int cellSize);
+void unloadSpriteAtlas(SpriteAtlas& atlas);
+
+// Top-left texel of a sprite's slot, padding included.
+inline void slotOrigin(const SpriteAtlas& atlas, int sprite, int& x, int& y) {
+    x = (sprite % atlas.columns) * atlas.slot;
+    y = (sprite / atlas.columns) * atlas.slot;
+}
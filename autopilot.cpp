@@ -0,0 +1,156 @@
+#include "autopilot.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+// same order as the replay format: right, left, up, down
+static const int DIRS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, -1 }, { 0, 1 } };
+
+Autopilot::Autopilot(int gridWidth, int gridHeight)
+    : plans(0), gridWidth(gridWidth), gridHeight(gridHeight),
+      words(0), rowWords(0), maxLayers(4 * (gridWidth + gridHeight)),
+      goalX(-1), goalY(-1), expectX(-1), expectY(-1) {
+    if ((int64_t)gridWidth * gridHeight > AUTOPILOT_MAX_CELLS) return;
+    words    = (gridWidth + 63) / 64;
+    rowWords = words * gridHeight;
+    blocked.resize(rowWords);
+    visited.resize(rowWords);
+    layers.resize((size_t)(gridWidth + gridHeight + 1) * rowWords);
+    route.reserve(maxLayers);
+}
+
+SimInput Autopilot::next(const GameSim& sim) {
+    if (sim.gameOver) return { 0, 0 };
+    const TrainCarriage& head = sim.train.head();
+    bool onRoute = !route.empty() && sim.cargoX == goalX && sim.cargoY == goalY &&
+                   head.x == expectX && head.y == expectY;
+    if (!onRoute && !plan(sim, true) && !plan(sim, false)) return escape(sim);
+
+    int d = route.back();
+    route.pop_back();
+    expectX = (head.x + DIRS[d][0] + gridWidth)  % gridWidth;
+    expectY = (head.y + DIRS[d][1] + gridHeight) % gridHeight;
+    return { DIRS[d][0], DIRS[d][1] };
+}
+
+bool Autopilot::plan(const GameSim& sim, bool avoidWalls) {
+    plans++;
+    route.clear();
+    goalX = sim.cargoX;
+    goalY = sim.cargoY;
+    if (rowWords == 0 || goalX < 0) return false;
+
+    const Train& train = sim.train;
+    int length = (int)train.length();
+    int hx = train.head().x, hy = train.head().y;
+
+    uint64_t padding = (gridWidth & 63) ? ~0ull << (gridWidth & 63) : 0;
+    std::fill(blocked.begin(), blocked.end(), 0);
+    std::fill(visited.begin(), visited.end(), 0);
+    for (int y = 0; y < gridHeight; y++) blocked[y * words + words - 1] = padding;
+    if (avoidWalls)
+        for (const Wall& w : sim.walls) setBit(blocked.data(), w.x, w.y);
+    for (int i = 0; i < length; i++) setBit(blocked.data(), train[i].x, train[i].y);
+
+    uint64_t* start = layer(0);
+    std::fill(start, start + rowWords, 0);
+    setBit(start, hx, hy);
+    setBit(visited.data(), hx, hy);
+
+    // the first step is the only one that has to rule out reversing
+    uint64_t* first = layer(1);
+    std::fill(first, first + rowWords, 0);
+    bool any = false;
+    for (int d = 0; d < 4; d++) {
+        if (DIRS[d][0] == -sim.dirX && DIRS[d][1] == -sim.dirY) continue;
+        int nx = (hx + DIRS[d][0] + gridWidth)  % gridWidth;
+        int ny = (hy + DIRS[d][1] + gridHeight) % gridHeight;
+        if (testBit(blocked.data(), nx, ny)) continue;
+        setBit(first, nx, ny);
+        setBit(visited.data(), nx, ny);
+        any = true;
+    }
+
+    int t = 1;
+    int edge = (gridWidth - 1) & 63;
+    while (any && !testBit(layer(t), goalX, goalY)) {
+        if (++t > maxLayers) return false;
+        if ((size_t)(t + 1) * rowWords > layers.size()) layers.resize((size_t)(t + 1) * rowWords);
+
+        // the carriage that leaves its cell before this step; a fresh one
+        // shares the cell with the carriage ahead, which leaves a move later
+        int leaving = length + 1 - t;
+        if (leaving >= 1 && leaving < length) {
+            const TrainCarriage& c = train[leaving];
+            const TrainCarriage& ahead = train[leaving - 1];
+            if ((c.x != ahead.x || c.y != ahead.y) && !(avoidWalls && sim.walls.contains(c.x, c.y)))
+                clearBit(blocked.data(), c.x, c.y);
+        }
+
+        // after t steps the search can only span rows head.y - t .. head.y + t
+        const uint64_t* prev = layer(t - 1);
+        uint64_t* cur = layer(t);
+        int span = std::min(gridHeight, 2 * t + 1);
+        if (span < gridHeight) std::fill(cur, cur + rowWords, 0);
+        uint64_t reached = 0;
+        for (int j = 0; j < span; j++) {
+            int y = span < gridHeight ? (hy - t + j + gridHeight) % gridHeight : j;
+            const uint64_t* mid  = prev + y * words;
+            const uint64_t* up   = prev + ((y + gridHeight - 1) % gridHeight) * words;
+            const uint64_t* down = prev + ((y + 1) % gridHeight) * words;
+            const uint64_t* wall = &blocked[y * words];
+            uint64_t* seen = &visited[y * words];
+            uint64_t* out  = cur + y * words;
+            // x = width - 1 wraps to 0 going east, x = 0 to width - 1 going west
+            uint64_t wrapEast = mid[words - 1] >> edge & 1;
+            uint64_t wrapWest = (mid[0] & 1) << edge;
+            for (int k = 0; k < words; k++) {
+                uint64_t east = mid[k] << 1 | (k > 0 ? mid[k - 1] >> 63 : wrapEast);
+                uint64_t west = mid[k] >> 1 | (k + 1 < words ? mid[k + 1] << 63 : wrapWest);
+                uint64_t next = (east | west | up[k] | down[k]) & ~wall[k] & ~seen[k];
+                out[k] = next;
+                seen[k] |= next;
+                reached |= next;
+            }
+        }
+        any = reached != 0;
+    }
+    if (!any) return false;
+
+    // walk back from the cargo through the layers
+    int x = goalX, y = goalY;
+    for (int s = t; s >= 1; s--) {
+        const uint64_t* from = layer(s - 1);
+        for (int d = 0; d < 4; d++) {
+            int px = (x - DIRS[d][0] + gridWidth)  % gridWidth;
+            int py = (y - DIRS[d][1] + gridHeight) % gridHeight;
+            if (testBit(from, px, py)) {
+                route.push_back((int8_t)d);
+                x = px;
+                y = py;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+// No route (or a board too big to search): take the safe neighbour closest
+// to the cargo, a wall only if nothing else is left.
+SimInput Autopilot::escape(const GameSim& sim) const {
+    const TrainCarriage& head = sim.train.head();
+    int best = -1, bestScore = INT_MIN;
+    for (int d = 0; d < 4; d++) {
+        if (DIRS[d][0] == -sim.dirX && DIRS[d][1] == -sim.dirY) continue;
+        int nx = (head.x + DIRS[d][0] + gridWidth)  % gridWidth;
+        int ny = (head.y + DIRS[d][1] + gridHeight) % gridHeight;
+        if (sim.train.isOnPosition(nx, ny)) continue;
+
+        int dx = std::abs(nx - sim.cargoX), dy = std::abs(ny - sim.cargoY);
+        int score = -std::min(dx, gridWidth - dx) - std::min(dy, gridHeight - dy);
+        if (sim.walls.contains(nx, ny)) score -= gridWidth + gridHeight;
+        if (score > bestScore) { best = d; bestScore = score; }
+    }
+    if (best < 0) return { 0, 0 };
+    return { DIRS[best][0], DIRS[best][1] };
+}
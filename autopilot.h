@@ -0,0 +1,52 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "sim.h"
+#include <cstdint>
+#include <vector>
+
+// Boards up to this many cells are planned with the bitset search; larger
+// (scrolling) worlds fall back to a greedy one-step choice.
+const int AUTOPILOT_MAX_CELLS = 1 << 16;
+
+// Steers a GameSim to its cargo. Plans a shortest path with a breadth-first
+// search over bitset rows, one layer per tick: each layer spreads the last
+// one to its four neighbours with word shifts (wrapping like the tick code)
+// and masks out walls and carriages. The body is handled through time: the
+// carriage i cells from the tail leaves its cell after i + 1 moves, so that
+// cell opens up at that layer. Walls are avoided; only when they cut the
+// cargo off does a second search drive through them.
+// The plan is kept and followed as long as the cargo stays put and the
+// train is where the plan expects; only then is a new search run. All
+// buffers are sized once per board and reused, so steering allocates
+// nothing in steady state.
+class Autopilot {
+public:
+    Autopilot(int gridWidth, int gridHeight);
+
+    // Input for the next GameSim::step; call once per tick.
+    SimInput next(const GameSim& sim);
+    void clear() { route.clear(); }
+
+    int plans;                          // searches run so far
+
+private:
+    bool plan(const GameSim& sim, bool avoidWalls);
+    SimInput escape(const GameSim& sim) const;
+    uint64_t* layer(int t) { return &layers[(size_t)t * rowWords]; }
+    void setBit(uint64_t* bits, int x, int y) const { bits[y * words + (x >> 6)] |= 1ull << (x & 63); }
+    void clearBit(uint64_t* bits, int x, int y) const { bits[y * words + (x >> 6)] &= ~(1ull << (x & 63)); }
+    bool testBit(const uint64_t* bits, int x, int y) const { return bits[y * words + (x >> 6)] >> (x & 63) & 1; }
+
+    int gridWidth, gridHeight;
+    int words, rowWords;                // 64-bit words per row, per grid
+    int maxLayers;
+    std::vector<uint64_t> blocked;      // walls and carriages; row padding set
+    std::vector<uint64_t> visited;
+    std::vector<uint64_t> layers;       // cells first reached at each step
+    std::vector<int8_t> route;          // directions still to drive, last first
+    int goalX, goalY;                   // cargo the route leads to
+    int expectX, expectY;               // head position the route assumes
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "batch.h"
+#include <algorithm>
+#include <cstring>
+
+static const int8_t actionDirX[5] = { 0, 1, -1, 0, 0 };
+static const int8_t actionDirY[5] = { 0, 0, 0, -1, 1 };
+
+BatchSim::BatchSim(int envCount, int gridWidth, int gridHeight, uint64_t seed, int threads)
+    : envCount(envCount), gridWidth(gridWidth), gridHeight(gridHeight),
+      cells(gridWidth * gridHeight), words((gridWidth * gridHeight + 63) / 64),
+      pool(threads) {
+    capacity = 1;
+    while (capacity < (uint32_t)cells + 1) capacity *= 2;
+    mask = capacity - 1;
+
+    body.resize((size_t)envCount * capacity);
+    first.resize(envCount);
+    length.resize(envCount);
+    grow.resize(envCount);
+    dirX.resize(envCount);
+    dirY.resize(envCount);
+    cargo.resize(envCount);
+    level.resize(envCount);
+    freeCount.resize(envCount);
+    rng.resize(envCount);
+    occupancy.resize((size_t)envCount * words);
+    walls.resize((size_t)envCount * words);
+    events.resize(envCount);
+    episodes.resize(envCount);
+    reset(seed);
+}
+
+void BatchSim::reset(uint64_t seed) {
+    for (int env = 0; env < envCount; env++) {
+        rng[env].reseed(seed + (uint64_t)env);
+        episodes[env] = 0;
+        events[env] = 0;
+        resetEnv(env);
+    }
+}
+
+void BatchSim::resetEnv(int env) {
+    uint64_t* occ  = &occupancy[(size_t)env * words];
+    uint64_t* wall = &walls[(size_t)env * words];
+    std::memset(occ, 0, words * sizeof(uint64_t));
+    std::memset(wall, 0, words * sizeof(uint64_t));
+
+    int start = (gridHeight / 2) * gridWidth + gridWidth / 2;
+    first[env]  = 0;
+    length[env] = 1;
+    grow[env]   = 0;
+    body[(size_t)env * capacity] = start;
+    occ[start >> 6] |= 1ull << (start & 63);
+
+    dirX[env] = 1; dirY[env] = 0;
+    level[env]     = 1;
+    freeCount[env] = cells - 1;
+    cargo[env]     = randomFreeCell(env, -1);
+}
+
+// Uniform free cell other than `exclude`, or -1. A few blind probes settle
+// almost every call; a crowded board falls back to selecting the n-th free
+// bit by popcount, which is bounded by the bitmap size.
+int BatchSim::randomFreeCell(int env, int exclude) {
+    const uint64_t* occ  = &occupancy[(size_t)env * words];
+    const uint64_t* wall = &walls[(size_t)env * words];
+    Rng& r = rng[env];
+
+    for (int attempt = 0; attempt < 16; attempt++) {
+        int c = r.below(cells);
+        if (c != exclude && !(((occ[c >> 6] | wall[c >> 6]) >> (c & 63)) & 1)) return c;
+    }
+
+    bool excludeFree = exclude >= 0 && !(((occ[exclude >> 6] | wall[exclude >> 6]) >> (exclude & 63)) & 1);
+    int available = freeCount[env] - (excludeFree ? 1 : 0);
+    if (available <= 0) return -1;
+
+    int n = r.below(available);
+    for (int w = 0; w < words; w++) {
+        uint64_t freeBits = ~(occ[w] | wall[w]);
+        if (w == words - 1 && (cells & 63)) freeBits &= (1ull << (cells & 63)) - 1;
+        if (excludeFree && (exclude >> 6) == w) freeBits &= ~(1ull << (exclude & 63));
+        int inWord = __builtin_popcountll(freeBits);
+        if (n >= inWord) { n -= inWord; continue; }
+        while (n--) freeBits &= freeBits - 1;
+        return w * 64 + __builtin_ctzll(freeBits);
+    }
+    return -1;
+}
+
+void BatchSim::stepEnv(int env, uint8_t action) {
+    uint64_t* occ  = &occupancy[(size_t)env * words];
+    uint64_t* wall = &walls[(size_t)env * words];
+    int32_t* ring  = &body[(size_t)env * capacity];
+    uint8_t ev = 0;
+
+    int8_t ax = actionDirX[action < 5 ? action : 0];
+    int8_t ay = actionDirY[action < 5 ? action : 0];
+    if ((ax || ay) && !(ax == -dirX[env] && ay == -dirY[env])) {
+        dirX[env] = ax;
+        dirY[env] = ay;
+    }
+
+    int head = ring[first[env]];
+    int hx = head % gridWidth, hy = head / gridWidth;
+    int nx = hx + dirX[env], ny = hy + dirY[env];
+    if (nx < 0) nx += gridWidth;  else if (nx == gridWidth)  nx = 0;
+    if (ny < 0) ny += gridHeight; else if (ny == gridHeight) ny = 0;
+    int next = ny * gridWidth + nx;
+    uint64_t bit = 1ull << (next & 63);
+
+    if (occ[next >> 6] & bit) {
+        events[env] = EVENT_CRASHED;
+        episodes[env]++;
+        resetEnv(env);
+        return;
+    }
+
+    // ---- brick-wall collision: lose the last carriage ----
+    bool hitWall = (wall[next >> 6] & bit) != 0;
+    if (hitWall) {
+        ev |= EVENT_HIT_WALL;
+        if (grow[env] > 0) {
+            grow[env]--;
+        } else if (length[env] > 1) {
+            int tail = ring[(first[env] + length[env] - 1) & mask];
+            occ[tail >> 6] &= ~(1ull << (tail & 63));
+            if (!((wall[tail >> 6] >> (tail & 63)) & 1)) freeCount[env]++;
+            length[env]--;
+        }
+    }
+
+    // ---- advance ----
+    if (grow[env] > 0) {
+        grow[env]--;
+    } else {
+        int tail = ring[(first[env] + length[env] - 1) & mask];
+        occ[tail >> 6] &= ~(1ull << (tail & 63));
+        if (!((wall[tail >> 6] >> (tail & 63)) & 1)) freeCount[env]++;
+        length[env]--;
+    }
+    first[env] = (first[env] - 1) & mask;
+    ring[first[env]] = next;
+    length[env]++;
+    occ[next >> 6] |= bit;
+    if (!hitWall) freeCount[env]--;
+
+    if (next == cargo[env]) {
+        ev |= EVENT_PICKED_CARGO;
+        grow[env]++;
+        level[env]++;
+        for (int i = 0; i < level[env] - 4; i++) {
+            int c = randomFreeCell(env, next);
+            if (c < 0) break;
+            wall[c >> 6] |= 1ull << (c & 63);
+            freeCount[env]--;
+        }
+        cargo[env] = randomFreeCell(env, -1);
+    }
+    events[env] = ev;
+}
+
+void BatchSim::step(const uint8_t* actions) {
+    pool.parallelFor(envCount, 256, [&](int begin, int end) {
+        for (int env = begin; env < end; env++) stepEnv(env, actions[env]);
+    });
+}
+
+static void mixHash(uint64_t& h, uint64_t v) {
+    h = (h ^ v) * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 32;
+}
+
+uint64_t BatchSim::stateHash(int env) const {
+    uint64_t h = 0x42415443ull;  // "BATC"
+    mixHash(h, (uint64_t)(uint32_t)dirX[env] << 32 | (uint32_t)dirY[env]);
+    mixHash(h, (uint64_t)(uint32_t)cargo[env] << 32 | (uint32_t)level[env]);
+    mixHash(h, (uint64_t)grow[env] << 32 | (uint32_t)freeCount[env]);
+    mixHash(h, rng[env].state);
+    mixHash(h, length[env]);
+    for (uint32_t i = 0; i < length[env]; i++) mixHash(h, (uint32_t)cell(env, (int)i));
+    const uint64_t* wall = &walls[(size_t)env * words];
+    for (int w = 0; w < words; w++) mixHash(h, wall[w]);
+    return h;
+}
+
+uint64_t BatchSim::stateHash() const {
+    uint64_t h = 0;
+    for (int env = 0; env < envCount; env++) mixHash(h, stateHash(env));
+    return h;
+}
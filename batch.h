@@ -0,0 +1,78 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "rng.h"
+#include "threadpool.h"
+#include <cstdint>
+#include <vector>
+
+// Actions for BatchSim::step, one byte per environment.
+enum BatchAction : uint8_t { ACTION_KEEP, ACTION_RIGHT, ACTION_LEFT, ACTION_UP, ACTION_DOWN };
+
+// Bits of BatchSim::events, set per environment by each step.
+enum BatchEvent : uint8_t {
+    EVENT_CRASHED      = 1,   // episode ended; the environment was reset
+    EVENT_HIT_WALL     = 2,
+    EVENT_PICKED_CARGO = 4,
+};
+
+// N independent games stepped together for bot training. Follows the same
+// rules as GameSim, but every piece of state is a flat per-environment
+// array (structure of arrays) and occupancy/walls are bitmaps, so a step
+// touches a few cache lines per game and no pointers. Crashed games reset
+// themselves within the same step. Environments draw from their own RNG
+// streams, so a BatchSim game is not bit-identical to a GameSim game with
+// the same seed, and walls are spawned without GameSim's connectivity check
+// (ConnectivityCheck).
+//
+// A new carriage is modelled as pending growth (the tail is kept on the
+// next move) instead of a duplicated tail cell; that is what lets the
+// occupancy be a bitmap rather than a counter grid.
+class BatchSim {
+public:
+    BatchSim(int envCount, int gridWidth, int gridHeight, uint64_t seed, int threads = 0);
+
+    void reset(uint64_t seed);
+    // actions[i] steers environment i; results land in `events`.
+    void step(const uint8_t* actions);
+
+    int headCell(int env) const  { return body[(size_t)env * capacity + first[env]]; }
+    int cell(int env, int i) const { return body[(size_t)env * capacity + ((first[env] + i) & mask)]; }
+    bool isOccupied(int env, int c) const { return testBit(occupancy, env, c); }
+    bool isWall(int env, int c) const     { return testBit(walls, env, c); }
+    // Digests of one environment and of the whole batch, for checking that
+    // two runs (say, with different thread counts) have not diverged.
+    uint64_t stateHash(int env) const;
+    uint64_t stateHash() const;
+
+    int envCount, gridWidth, gridHeight;
+    int cells, words;                    // cells per grid, 64-bit words per bitmap
+    uint32_t capacity, mask;             // body ring size per environment
+
+    // ----------  PER-ENVIRONMENT STATE (index = env)  ----------
+    std::vector<int32_t>  body;          // envCount * capacity cell indices, ring per env
+    std::vector<uint32_t> first;         // ring slot of the locomotive
+    std::vector<uint32_t> length;
+    std::vector<uint32_t> grow;          // carriages still to be added at the tail
+    std::vector<int8_t>   dirX, dirY;
+    std::vector<int32_t>  cargo;         // cell index, -1 when the board is full
+    std::vector<int32_t>  level;
+    std::vector<int32_t>  freeCount;     // cells with neither carriage nor wall
+    std::vector<Rng>      rng;
+    std::vector<uint64_t> occupancy;     // envCount * words
+    std::vector<uint64_t> walls;         // envCount * words
+    std::vector<uint8_t>  events;
+    std::vector<uint32_t> episodes;
+
+private:
+    bool testBit(const std::vector<uint64_t>& bits, int env, int c) const {
+        return (bits[(size_t)env * words + (c >> 6)] >> (c & 63)) & 1;
+    }
+    void resetEnv(int env);
+    void stepEnv(int env, uint8_t action);
+    int randomFreeCell(int env, int exclude);
+
+    WorkStealingPool pool;
+};
+
+#endif
@@ -0,0 +1,253 @@
+// Benchmarks for the simulation hot paths. Build without raylib:
+//   g++ -O2 -std=c++17 -pthread bench.cpp sim.cpp train.cpp occupancy.cpp freecells.cpp
+//       walls.cpp batch.cpp threadpool.cpp autopilot.cpp snapshot.cpp
+//       particles.cpp connectivity.cpp -o bench
+// Prints a table and writes the same rows as CSV (default bench_output.txt).
+#include "sim.h"
+#include "batch.h"
+#include "autopilot.h"
+#include "snapshot.h"
+#include "particles.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// ----------  ALLOCATION COUNTING  ----------
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// ----------  HARNESS  ----------
+struct Result {
+    std::string name;
+    long length, grid, walls;
+    double nsPerOp, allocsPerOp;
+};
+
+static std::vector<Result> results;
+static volatile long sink = 0;
+
+using Clock = std::chrono::steady_clock;
+
+// Runs `op` in growing batches until a batch takes at least ~50 ms.
+// `perCall` is how many operations one call of `op` stands for.
+template <typename Op>
+void measure(const char* name, long length, long grid, long walls, Op op, long perCall = 1) {
+    long iterations = 1;
+    for (;;) {
+        size_t allocsBefore = allocations;
+        Clock::time_point start = Clock::now();
+        for (long i = 0; i < iterations; i++) op(i);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (ns >= 5e7 || iterations >= (1L << 30)) {
+            double ops = (double)iterations * perCall;
+            results.push_back({ name, length, grid, walls, ns / ops,
+                                double(allocations - allocsBefore) / ops });
+            const Result& r = results.back();
+            printf("%-14s len=%-7ld grid=%-5ld walls=%-6ld %10.1f ns/op %8.3f allocs/op %12.0f ops/s\n",
+                   r.name.c_str(), length, grid, walls, r.nsPerOp, r.allocsPerOp, 1e9 / r.nsPerOp);
+            return;
+        }
+        iterations *= ns < 1e6 ? 10 : 2;
+    }
+}
+
+// Boustrophedon walk over a square grid, so consecutive cells are adjacent
+// and a train laid along it never overlaps itself.
+static void snakeCell(long k, int grid, int& x, int& y) {
+    k %= (long)grid * grid;
+    y = (int)(k / grid);
+    x = (int)(k % grid);
+    if (y & 1) x = grid - 1 - x;
+}
+
+static Train buildTrain(long length, int grid) {
+    Train train(0, 0, grid, grid);
+    for (long k = 1; k < length; k++) {
+        int x, y;
+        snakeCell(k, grid, x, y);
+        train.addCarriage();
+        train.move(x, y);
+    }
+    return train;
+}
+
+static int gridFor(long length) {
+    int grid = 64;
+    while ((long)grid * grid < 2 * length) grid *= 2;
+    return grid;
+}
+
+// ----------  BENCHMARKS  ----------
+static void benchTrain(long length) {
+    int grid = gridFor(length);
+    Train train = buildTrain(length, grid);
+    long step = length;
+
+    measure("train.move", length, grid, 0, [&](long) {
+        int x, y;
+        snakeCell(step++, grid, x, y);
+        train.move(x, y);
+    });
+
+    Rng rng(1);
+    measure("isOnPosition", length, grid, 0, [&](long) {
+        sink += train.isOnPosition(rng.below(grid), rng.below(grid));
+    });
+
+    measure("addCarriage", length, grid, 0, [&](long i) {
+        // strip again so the length under test stays put
+        if (i & 1) train.stripLastCarriage();
+        else       train.addCarriage();
+    });
+}
+
+static void benchPlaceCargo(long length) {
+    int grid = gridFor(length);
+    Train train = buildTrain(length, grid);
+    FreeCellSet freeCells(grid, grid);
+    train.trackFreeCells(&freeCells);
+    Rng rng(2);
+    int cargoX, cargoY;
+
+    measure("placeCargo", length, grid, 0, [&](long) {
+        sink += placeCargo(cargoX, cargoY, freeCells, rng);
+    });
+}
+
+static void benchSpawnWalls(int grid, long wallCount) {
+    GameSim sim(grid, grid, 3);
+    measure("spawnWalls", 1, grid, wallCount, [&](long) {
+        // keep the board from filling up; the reset is amortised over many calls
+        if (sim.walls.size() > (size_t)grid * grid / 8) sim.reset(3);
+        sim.level = (int)wallCount + 4;
+        sim.spawnWalls();
+    });
+}
+
+// Full-state snapshot of a board whose train is `length` long: taking one
+// into a reused buffer, and checking + restoring it.
+static void benchSnapshot(long length) {
+    int grid = gridFor(length);
+    GameSim sim(grid, grid, 6);
+    sim.freeCells.reset();
+    sim.train = buildTrain(length, grid);
+    sim.train.trackFreeCells(&sim.freeCells);
+    std::vector<uint8_t> blob, scratch;
+
+    measure("snapshot.take", length, grid, 0, [&](long i) {
+        takeSnapshot(blob, sim, 0.0f, (uint32_t)i);
+    });
+    measure("snapshot.load", length, grid, 0, [&](long) {
+        sink += restoreSnapshot(sim, viewSnapshot(blob.data(), blob.size()), scratch);
+    });
+}
+
+// A bot steering straight at the cargo, so ticks include pickups, wall
+// spawns and the occasional crash + reset.
+static void benchTick(int grid, long wallCount) {
+    GameSim sim(grid, grid, 4);
+    auto prepare = [&]() {
+        sim.reset(4);
+        sim.level = (int)wallCount + 4;
+        sim.spawnWalls();
+        sim.level = 1;
+    };
+    prepare();
+
+    measure("tick", 1, grid, wallCount, [&](long) {
+        SimInput input = { 0, 0 };
+        int dx = sim.cargoX - sim.train.head().x;
+        int dy = sim.cargoY - sim.train.head().y;
+        if (dx)      input = { dx > 0 ? 1 : -1, 0 };
+        else if (dy) input = { 0, dy > 0 ? 1 : -1 };
+        if (sim.step(input).crashed || sim.level > 40) prepare();
+    });
+}
+
+// Same game loop steered by the Autopilot; one op is planning (when the
+// cargo moved) plus the tick.
+static void benchAutopilot(int grid, long wallCount) {
+    GameSim sim(grid, grid, 4);
+    Autopilot autopilot(grid, grid);
+    auto prepare = [&]() {
+        sim.reset(4);
+        sim.level = (int)wallCount + 4;
+        sim.spawnWalls();
+        sim.level = 1;
+        autopilot.clear();
+    };
+    prepare();
+
+    measure("autopilot", 1, grid, wallCount, [&](long) {
+        if (sim.step(autopilot.next(sim)).crashed || sim.level > 40) prepare();
+    });
+}
+
+// Environment steps through BatchSim, bot as above; one op is one game
+// advancing one tick.
+static void benchBatch(int envs, int grid) {
+    BatchSim batch(envs, grid, grid, 5);
+    std::vector<uint8_t> actions(envs);
+
+    measure("batch.step", envs, grid, 0, [&](long) {
+        for (int env = 0; env < envs; env++) {
+            int cargo = batch.cargo[env], head = batch.headCell(env);
+            int dx = cargo % grid - head % grid, dy = cargo / grid - head / grid;
+            actions[env] = cargo < 0 ? ACTION_KEEP : dx > 0 ? ACTION_RIGHT : dx < 0 ? ACTION_LEFT
+                                                 : dy < 0 ? ACTION_UP : ACTION_DOWN;
+        }
+        batch.step(actions.data());
+    }, envs);
+}
+
+// One 60 Hz frame of a pool held at `live` particles, the expired ones
+// re-emitted; one op is one particle advanced.
+static void benchParticles(int live) {
+    ParticlePool pool;
+    initParticles(pool, PARTICLE_CAPACITY, 11);
+
+    measure("particles", live, 0, 0, [&](long i) {
+        emitParticles(pool, (ParticleEffect)(i % EFFECT_COUNT), 100.0f, 100.0f, live - pool.count, 1.0f, 0.0f);
+        updateParticles(pool, 1.0f / 60.0f);
+        sink += pool.count;
+    }, live);
+}
+
+static void writeCsv(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) { perror(path); return; }
+    fprintf(f, "benchmark,length,grid,walls,ns_per_op,allocs_per_op,ops_per_sec\n");
+    for (const Result& r : results)
+        fprintf(f, "%s,%ld,%ld,%ld,%.2f,%.4f,%.0f\n", r.name.c_str(), r.length, r.grid,
+                r.walls, r.nsPerOp, r.allocsPerOp, 1e9 / r.nsPerOp);
+    fclose(f);
+}
+
+int main(int argc, char** argv) {
+    const char* csvPath = argc > 1 ? argv[1] : "bench_output.txt";
+
+    for (long length : { 1L, 10L, 100L, 1000L, 10000L, 100000L }) benchTrain(length);
+    for (long length : { 1L, 1000L, 100000L }) benchPlaceCargo(length);
+    for (int grid : { 64, 256, 1024 })
+        for (long walls : { 1L, 16L, 256L }) benchSpawnWalls(grid, walls);
+    for (int grid : { 40, 256, 1024 })
+        for (long walls : { 0L, 100L, 1000L }) benchTick(grid, walls);
+    for (int grid : { 40, 256 })
+        for (long walls : { 0L, 100L }) benchAutopilot(grid, walls);
+    for (int envs : { 256, 4096, 16384 }) benchBatch(envs, 40);
+    for (long length : { 1L, 1000L, 100000L }) benchSnapshot(length);
+    for (int live : { 256, 4096 }) benchParticles(live);
+
+    writeCsv(csvPath);
+    return 0;
+}
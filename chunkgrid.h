@@ -0,0 +1,79 @@
+#ifndef CHUNKGRID_H
+#define CHUNKGRID_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-cell values stored in CHUNK x CHUNK blocks that are only allocated on
+// first write; reads from an unallocated block return T(). A small board is
+// a single block, while a huge world costs memory only where something is
+// (the train, walls) plus four bytes per block. Blocks the owner has put
+// back to all T() can be released; they are recycled as they are by the
+// next allocation, without clearing.
+template <typename T>
+class ChunkedGrid {
+public:
+    static constexpr int CHUNK_BITS = 6;
+    static constexpr int CHUNK = 1 << CHUNK_BITS;
+
+    ChunkedGrid(int width, int height)
+        : width(width), height(height),
+          chunksX((width + CHUNK - 1) >> CHUNK_BITS),
+          chunksY((height + CHUNK - 1) >> CHUNK_BITS),
+          offsets((size_t)chunksX * chunksY, NONE) {}
+
+    T get(int x, int y) const {
+        uint32_t offset = offsets[chunkOf(x, y)];
+        return offset == NONE ? T() : cells[offset + cellOf(x, y)];
+    }
+
+    T& at(int x, int y) {
+        uint32_t& offset = offsets[chunkOf(x, y)];
+        if (offset == NONE) {
+            if (spare.empty()) {
+                offset = (uint32_t)cells.size();
+                cells.resize(cells.size() + CHUNK * CHUNK, T());
+            } else {
+                offset = spare.back();
+                spare.pop_back();
+            }
+        }
+        return cells[offset + cellOf(x, y)];
+    }
+
+    int chunkOf(int x, int y) const { return (y >> CHUNK_BITS) * chunksX + (x >> CHUNK_BITS); }
+
+    void release(int chunk) {
+        if (offsets[chunk] == NONE) return;
+        spare.push_back(offsets[chunk]);
+        offsets[chunk] = NONE;
+    }
+
+    // true if block (cx, cy) was never written, so every cell in it is T()
+    bool chunkEmpty(int cx, int cy) const { return offsets[cy * chunksX + cx] == NONE; }
+
+    // every cell reads T() again; the blocks stay allocated as spares
+    void clear() {
+        std::fill(cells.begin(), cells.end(), T());
+        std::fill(offsets.begin(), offsets.end(), NONE);
+        spare.clear();
+        for (size_t offset = 0; offset < cells.size(); offset += CHUNK * CHUNK)
+            spare.push_back((uint32_t)offset);
+    }
+
+    int width, height;
+    int chunksX, chunksY;
+
+private:
+    static constexpr uint32_t NONE = ~0u;
+
+    static int cellOf(int x, int y) { return (y & (CHUNK - 1)) << CHUNK_BITS | (x & (CHUNK - 1)); }
+
+    std::vector<uint32_t> offsets;      // chunk -> first cell in `cells`
+    std::vector<T> cells;               // allocated chunks, in first-write order
+    std::vector<uint32_t> spare;        // released chunks awaiting reuse
+};
+
+#endif
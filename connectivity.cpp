@@ -0,0 +1,115 @@
+#include "connectivity.h"
+
+// the ring around a cell, in order; even entries are the four neighbours
+static const int RING[8][2] = {
+    { 0, -1 }, { 1, -1 }, { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }
+};
+
+Wall ConnectivityCheck::step(int x, int y, int ring) const {
+    x += RING[ring][0];
+    y += RING[ring][1];
+    if (x < 0) x += gridWidth;  else if (x >= gridWidth)  x -= gridWidth;
+    if (y < 0) y += gridHeight; else if (y >= gridHeight) y -= gridHeight;
+    return { x, y };
+}
+
+ConnectivityCheck::ConnectivityCheck(int gridWidth, int gridHeight)
+    : gridWidth(gridWidth), gridHeight(gridHeight),
+      seen(gridWidth, gridHeight), stamp(0) {
+    for (std::vector<Wall>& queue : queues) queue.reserve(WALL_SEARCH_BUDGET + 4);
+}
+
+bool ConnectivityCheck::keepsConnected(const WallSet& walls, int x, int y, bool search) {
+    Wall ring[8];
+    bool open[8];
+    for (int i = 0; i < 8; i++) {
+        ring[i] = step(x, y, i);
+        open[i] = !walls.contains(ring[i].x, ring[i].y);
+    }
+
+    // one seed neighbour per run of open ring cells; a run starts after a
+    // closed cell, so begin the walk just after one
+    Wall seeds[4];
+    int count = 0, start = 0;
+    while (start < 8 && open[start]) start++;
+    if (start == 8) return true;                // nothing around c is walled
+    bool seeded = false;
+    for (int k = 1; k <= 8; k++) {
+        int i = (start + k) & 7;
+        if (!open[i]) { seeded = false; continue; }
+        if ((i & 1) == 0 && !seeded) {
+            seeds[count++] = ring[i];
+            seeded = true;
+        }
+    }
+    if (count <= 1) return true;
+    if (!search) return false;
+    return connectedWithout(walls, x, y, seeds, count);
+}
+
+// Grows one search per seed in turns, each claiming cells for itself. When
+// two searches touch, their seeds are joined (a four-element union-find);
+// once all are joined the wall is safe. If every search of a joined group
+// runs dry first, that group is closed off from the rest. Searching from all
+// sides at once makes the cost follow the smaller side: a pocket is found
+// after visiting the pocket, a detour after visiting about its area.
+bool ConnectivityCheck::connectedWithout(const WallSet& walls, int x, int y, const Wall* seeds, int count) {
+    if (++stamp == STAMP_LIMIT) {               // wrapped: forget every old mark
+        seen.clear();
+        stamp = 1;
+    }
+    const uint32_t base = stamp << 3;           // low bits: owning search + 1
+    seen.at(x, y) = base | 7;                   // the candidate wall
+
+    int parent[4];
+    size_t head[4];
+    int groups = count;
+    auto find = [&](int i) { while (parent[i] != i) i = parent[i]; return i; };
+    auto join = [&](int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        parent[b] = a;
+        return --groups == 1;
+    };
+
+    for (int i = 0; i < count; i++) {
+        parent[i] = i;
+        head[i] = 0;
+        queues[i].clear();
+        uint32_t& mark = seen.at(seeds[i].x, seeds[i].y);
+        if ((mark & ~7u) == base) {             // same cell as an earlier seed
+            if (join((int)(mark & 7) - 1, i)) return true;
+            continue;
+        }
+        mark = base | (i + 1);
+        queues[i].push_back(seeds[i]);
+    }
+
+    int visited = count;
+    for (;;) {
+        for (int i = 0; i < count; i++) {
+            if (head[i] == queues[i].size()) continue;
+            Wall c = queues[i][head[i]++];
+            for (int d = 0; d < 8; d += 2) {
+                Wall n = step(c.x, c.y, d);
+                uint32_t& mark = seen.at(n.x, n.y);
+                if ((mark & ~7u) == base) {
+                    int owner = (int)(mark & 7) - 1;
+                    if (owner < 4 && join(owner, i)) return true;
+                    continue;
+                }
+                if (walls.contains(n.x, n.y)) continue;
+                mark = base | (i + 1);
+                queues[i].push_back(n);
+                if (++visited > WALL_SEARCH_BUDGET) return false;
+            }
+        }
+        // a group whose searches all ran dry is enclosed
+        bool active[4] = { false, false, false, false };
+        for (int i = 0; i < count; i++)
+            if (head[i] < queues[i].size()) active[find(i)] = true;
+        for (int i = 0; i < count; i++)
+            if (find(i) == i && !active[i]) return false;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+#include "chunkgrid.h"
+#include "walls.h"
+#include <cstdint>
+#include <vector>
+
+const int WALL_SEARCH_BUDGET = 1024;    // cells one connectivity search may visit
+const int WALL_ATTEMPTS = 16;           // candidates tried per wall before giving up;
+                                        // the first half only take clear-cut ones
+
+// Decides where GameSim::spawnWalls may put a wall so that the wall-free
+// cells of the torus stay one connected region: the cargo, wherever it is
+// or will be put, can always be reached without driving through a wall.
+//
+// A wall on cell c can only cut the board if its free neighbours are not
+// already joined around c. Walking the eight cells around c settles that in
+// almost every case: runs of free cells in that ring are connected, so one
+// run touching all free neighbours means the wall is safe. Only when the
+// ring is split do breadth-first searches run from the neighbours towards
+// each other, together capped at WALL_SEARCH_BUDGET cells; hitting the cap
+// counts as a cut. Either way a wall costs a bounded amount of work,
+// independent of the board size, and nothing is tracked between walls, so
+// any WallSet can be checked.
+class ConnectivityCheck {
+public:
+    ConnectivityCheck(int gridWidth, int gridHeight);
+
+    // true if a wall on (x, y) leaves its free neighbours connected; with
+    // `search` false a split ring is taken as a cut without searching, which
+    // is what a caller with other candidates to try wants first
+    bool keepsConnected(const WallSet& walls, int x, int y, bool search = true);
+
+private:
+    Wall step(int x, int y, int ring) const;   // wrapped cell RING[ring] away
+    bool connectedWithout(const WallSet& walls, int x, int y, const Wall* seeds, int count);
+
+    int gridWidth, gridHeight;
+    static const uint32_t STAMP_LIMIT = 1u << 29;
+
+    ChunkedGrid<uint32_t> seen;         // stamp << 3 | owner: claimed by the current check
+    uint32_t stamp;
+    std::vector<Wall> queues[4];        // one search per free neighbour
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "freecells.h"
+#include <cstddef>
+
+FreeCellSet::FreeCellSet(int width, int height)
+    : width(width), height(height) {
+    size_t cells = (size_t)width * height;
+    users.resize(cells);
+    dense.reserve(cells);
+    slot.resize(cells);
+    reset();
+}
+
+void FreeCellSet::occupy(int x, int y) {
+    int cell = y * width + x;
+    if (users[cell]++ != 0) return;
+
+    int moved = dense.back();
+    dense[slot[cell]] = moved;
+    slot[moved] = slot[cell];
+    dense.pop_back();
+    slot[cell] = -1;
+}
+
+void FreeCellSet::release(int x, int y) {
+    int cell = y * width + x;
+    if (--users[cell] != 0) return;
+
+    slot[cell] = (int)dense.size();
+    dense.push_back(cell);
+}
+
+void FreeCellSet::reset() {
+    dense.clear();
+    for (int cell = 0; cell < width * height; cell++) {
+        users[cell] = 0;
+        slot[cell] = cell;
+        dense.push_back(cell);
+    }
+}
+
+bool FreeCellSet::reorder(const int32_t* cells, int count) {
+    bool ok = count == (int)dense.size();
+    for (int i = 0; ok && i < count; i++) {
+        int cell = cells[i];
+        ok = cell >= 0 && cell < width * height && users[cell] == 0;
+    }
+    if (ok) {
+        for (int i = 0; i < count; i++) {
+            dense[i] = cells[i];
+            slot[cells[i]] = i;
+        }
+        // a repeated cell leaves its first slot pointing elsewhere
+        for (int i = 0; ok && i < count; i++) ok = slot[dense[i]] == i;
+        if (ok) return true;
+    }
+
+    dense.clear();
+    for (int cell = 0; cell < width * height; cell++) {
+        slot[cell] = users[cell] == 0 ? (int)dense.size() : -1;
+        if (users[cell] == 0) dense.push_back(cell);
+    }
+    return false;
+}
+
+bool placeCargo(int& cargoX, int& cargoY, const FreeCellSet& freeCells, Rng& rng) {
+    if (freeCells.count() == 0) {
+        return false;  // no place for cargo, game over condition
+    }
+
+    freeCells.cellAt(rng.below(freeCells.count()), cargoX, cargoY);
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef FREECELLS_H
+#define FREECELLS_H
+
+#include "rng.h"
+#include <cstdint>
+#include <vector>
+
+// Set of grid cells that hold neither a carriage nor a wall. Free cells are
+// kept densely packed with a cell -> slot map, so insertion and removal are a
+// swap with the last entry and picking a random free cell is one index.
+// Cells are reference counted because a carriage can sit on top of a wall.
+class FreeCellSet {
+public:
+    FreeCellSet(int width, int height);
+
+    void occupy(int x, int y);
+    void release(int x, int y);
+    void reset();
+    // Puts the free cells (y * width + x) into the given order, which is what
+    // random picks depend on. The cells must be exactly the current free set;
+    // if not, false, and the set is rebuilt in cell order.
+    bool reorder(const int32_t* cells, int count);
+    const int* order() const { return dense.data(); }
+
+    bool isFree(int x, int y) const { return slot[y * width + x] >= 0; }
+    int count() const { return (int)dense.size(); }
+    void cellAt(int i, int& x, int& y) const { x = dense[i] % width; y = dense[i] / width; }
+
+    int width, height;
+
+private:
+    std::vector<uint16_t> users;
+    std::vector<int> dense;
+    std::vector<int> slot;
+};
+
+bool placeCargo(int& cargoX, int& cargoY, const FreeCellSet& freeCells, Rng& rng);
+
+#endif
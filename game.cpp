@@ -1,102 +1,152 @@
-#include "train.h"
+#include "sim.h"
+#include "autopilot.h"
+#include "inputqueue.h"
 #include "graphics.h"
+#include "playfield.h"
+#include "hud.h"
+#include "scene.h"
+#include "worldview.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "profiler.h"
+#include "render.h"
 #include "raylib.h"
-#include <cstdlib>
-#include <ctime>
-#include <cmath>
-#include <vector>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 
-// ----------  WALL SYSTEM  ----------
-struct Wall {
-    int x, y;
-};
-std::vector<Wall> walls;
+// ----------  CAMERA SHAKE  ----------
 float shakeTime = 0.0f;        // seconds left
 float shakeIntensity = 12.0f;  // pixels
-
-// ----------  WALL HELPERS  ----------
-void drawBrickWall(int gx, int gy, int cellSize, int offsetY) {
-    int px = gx * cellSize;
-    int py = gy * cellSize + offsetY;
-    Color mortar = { 160, 82, 45, 255 };   // brownish
-    DrawRectangle(px, py, cellSize, cellSize, mortar);
-
-    int rows = 4;
-    int rowH = cellSize / rows;
-    for (int r = 0; r < rows; ++r) {
-        bool oddRow = (r & 1);
-        int bricksPerRow = 3;
-        int brickW = cellSize / bricksPerRow;
-        for (int b = 0; b < bricksPerRow; ++b) {
-            int bx = px + b * brickW + (oddRow ? brickW / 2 : 0);
-            int by = py + r * rowH;
-            Color brick = { 178, 34, 34, 255 };  // red brick
-            DrawRectangle(bx, by, brickW - 2, rowH - 2, brick);
-            DrawRectangle(bx, by, brickW - 2, 2, { 200, 70, 70, 255 }); // highlight
-        }
-    }
-    DrawRectangleLines(px, py, cellSize, cellSize, DARKBROWN);
-}
-
-void spawnWalls(int level, int gridWidth, int gridHeight, const Train& train, int cargoX, int cargoY) {
-    if (level < 5) return;
-    int count = level - 4;
-    for (int i = 0; i < count; ++i) {
-        int wx, wy;
-        do {
-            wx = rand() % gridWidth;
-            wy = rand() % gridHeight;
-        } while (train.isOnPosition(wx, wy) || (wx == cargoX && wy == cargoY));
-        walls.push_back({wx, wy});
-    }
-}
-
-void stripLastCarriage(Train& train) {
-    if (train.head == train.tail) return;
-    TrainCarriage* cur = train.head;
-    while (cur->next != train.tail) cur = cur->next;
-    delete train.tail;
-    train.tail = cur;
-    train.tail->next = nullptr;
-}
+Rng shakeRng;                  // seeded per game, so replays shake alike
 
 // ----------  GAME  ----------
+const int MAX_TICKS_PER_FRAME = 8;   // beyond this a slow frame drops time
+const int REWIND_TICKS = 64;         // snapshots kept for BACKSPACE rewinding
+const std::size_t REWIND_BYTES = 32u << 20;  // fewer ticks are kept on big boards
+const int64_t SNAPSHOT_CELL_LIMIT = 1 << 18; // larger worlds have no rewind or resume
+const int RESUME_EVERY_TICKS = 24;   // how often the resume file is rewritten
+const char* const RESUME_PATH = "resume.tgs";
+const float SMOKE_INTERVAL = 0.05f;  // seconds between chimney puffs
+
 enum GameState { START_MENU, PLAYING, GAME_OVER };
 
-int main() {
+int main(int argc, char** argv) {
     const int screenWidth = 800;
     const int screenHeight = 600;
+    SetConfigFlags(FLAG_VSYNC_HINT);
     InitWindow(screenWidth, screenHeight, "Train Adventure");
 
     const int topBarHeight = 60;
     const int cellSize = 20;
-    const int gridWidth  = screenWidth / cellSize;
-    const int gridHeight = (screenHeight - topBarHeight) / cellSize;
-
-    Train train(gridWidth / 2, gridHeight / 2);
-
-    int dirX = 1;
-    int dirY = 0;
-
-    srand(static_cast<unsigned>(time(nullptr)));
-    int cargoX = rand() % gridWidth;
-    int cargoY = rand() % gridHeight;
-
-    int level = 1;
-    float speed = 5.0f;
+    int gridWidth  = screenWidth / cellSize;
+    int gridHeight = (screenHeight - topBarHeight) / cellSize;
+
+    // --world WxH plays on a scrolling W x H grid (e.g. 10000x10000) instead
+    // of the screen-sized board
+    bool hugeWorld = false;
+    for (int i = 1; i + 1 < argc; i++) {
+        int w, h;
+        if (std::strcmp(argv[i], "--world") == 0 && std::sscanf(argv[i + 1], "%dx%d", &w, &h) == 2 &&
+            w > 1 && h > 1 && w <= 65535 && h <= 65535) {
+            gridWidth = w;
+            gridHeight = h;
+            hugeWorld = true;
+        }
+    }
+    const int offsetY = hugeWorld ? 0 : topBarHeight;
+
+    SpriteAtlas atlas = loadSpriteAtlas(cellSize);
+    Playfield playfield = {};
+    WorldView view = {};
+    if (hugeWorld) view = loadWorldView(gridWidth, gridHeight, cellSize);
+    else playfield = loadPlayfield(gridWidth, gridHeight, cellSize);
+    std::vector<ParallaxLayer> background;
+    loadBackground(background, screenWidth, screenHeight, 1.0f);
+    Hud hud = loadHud(screenWidth);
+
+    // menu and game-over text never changes; measure it once
+    const int midY = screenHeight / 2;
+    const TextLine titleText    = centredText("TRAIN ADVENTURE", 40, screenWidth, 120);
+    const TextLine startText    = centredText("Press ENTER to Start", 20, screenWidth, 200);
+    const TextLine resumeText   = centredText("Press R to resume your last game", 20, screenWidth, 240);
+    const TextLine gameOverText = centredText("GAME OVER", 60, screenWidth, midY - 45);
+    const TextLine restartText  = centredText("Press ENTER to Restart", 24, screenWidth, midY + 20);
+    const TextLine rewindText   = centredText("Hold BACKSPACE to rewind", 20, screenWidth, midY + 60);
+
+    uint64_t seed = (uint64_t)std::time(nullptr);
+    GameSim sim(gridWidth, gridHeight, seed);
+    Replay replay;
+    InputQueue turns;                   // arrow presses waiting for their tick
+    clearInputQueue(turns);
+    Autopilot autopilot(gridWidth, gridHeight);
+    bool autopilotOn = false;           // A toggles it against the arrow keys
     float timer = 0.0f;
 
+    ParticlePool particles;
+    initParticles(particles, PARTICLE_CAPACITY, seed);
+    float smokeClock = 0.0f;
+    auto emitAtHead = [&](ParticleEffect effect, int count) {
+        const TrainCarriage& head = sim.train.head();
+        emitParticles(particles, effect, (head.x + 0.5f) * cellSize, (head.y + 0.5f) * cellSize + offsetY,
+                      count, (float)sim.dirX, (float)sim.dirY);
+    };
+
+    // the last ticks for rewinding, and the latest state on disk so a game
+    // survives a crash or a closed window. A snapshot stores every free
+    // cell, so its size follows the board: a free cell costs 4 bytes, a
+    // carriage or wall 8.
+    int64_t boardCells = (int64_t)gridWidth * gridHeight;
+    bool snapshots = boardCells <= SNAPSHOT_CELL_LIMIT;
+    int rewindTicks = snapshots ? (int)std::min<std::size_t>(REWIND_TICKS, REWIND_BYTES / (boardCells * 8)) : 0;
+    SnapshotRing rewind;
+    initSnapshotRing(rewind, rewindTicks);
+    std::vector<uint8_t> resumeBlob;
+    std::vector<uint8_t> restoreScratch;    // reused by every rewind step
+    uint32_t resumeTick = 0;            // replay tick the resume file was written at
+    const SnapshotHeader* resumable = snapshots && loadSnapshot(resumeBlob, RESUME_PATH)
+        ? viewSnapshot(resumeBlob.data(), resumeBlob.size()) : nullptr;
+    if (resumable && (resumable->gridWidth != gridWidth || resumable->gridHeight != gridHeight))
+        resumable = nullptr;
+    bool saveReplays = true;            // off for a resumed game, whose start is unknown
+
+    auto rewindTick = [&]() {
+        const SnapshotHeader* snapshot = popSnapshot(rewind);
+        if (!snapshot || !restoreSnapshot(sim, snapshot, restoreScratch)) return false;
+        timer = snapshot->timer;
+        rewindReplay(replay, snapshot->tick);
+        resumeTick = std::min(resumeTick, snapshot->tick);
+        autopilot.clear();
+        clearInputQueue(turns);
+        return true;
+    };
+
+    // draws what the helpers recorded since the last pass, under the
+    // camera that is active now
+    auto submitPass = [&]() {
+        ProfileScope scope(PHASE_PRESENT);
+        submitRenderList();
+    };
+
     GameState gameState = START_MENU;
 
     float blinkTimer = 0.0f;
     bool showPrompt   = true;
 
-    SetTargetFPS(60);
-
     while (!WindowShouldClose()) {
         float deltaTime = GetFrameTime();
-        float time      = GetTime();
+        double now      = GetTime();    // input timestamps keep the double
+        float time      = (float)now;
+        beginProfileFrame();
+        renderList.frame = {};
+
+        if (IsKeyPressed(KEY_F3)) profiler.overlay = !profiler.overlay;
+        if (IsKeyPressed(KEY_F4)) {
+            if (profiler.csv) stopProfileCsv();
+            else startProfileCsv(TextFormat("profile_%llu.csv", (unsigned long long)std::time(nullptr)));
+        }
 
         switch (gameState) {
         case START_MENU: {
@@ -105,8 +155,8 @@ int main() {
 
             BeginDrawing();
             ClearBackground({135, 206, 235, 255});
-            drawHills(screenWidth, screenHeight, time);
-            drawClouds(screenWidth, screenHeight, time);
+            drawParallax(background, screenWidth, time);
+            submitRenderList();
 
             static float trainX = 0.0f;
             static float trainSpeed = 60.0f;
@@ -118,20 +168,38 @@ int main() {
             DrawCircle(int(trainX + 70), GetScreenHeight() - 40, 15, BLACK);
             DrawCircle(int(trainX + 150), GetScreenHeight() - 40, 15, BLACK);
 
-            DrawText("TRAIN ADVENTURE", GetScreenWidth()/2 - MeasureText("TRAIN ADVENTURE", 40)/2, 120, 40, DARKBLUE);
-            if (showPrompt) DrawText("Press ENTER to Start", GetScreenWidth()/2 - MeasureText("Press ENTER to Start", 20)/2, 200, 20, DARKGRAY);
+            drawTextLine(titleText, DARKBLUE);
+            if (showPrompt) drawTextLine(startText, DARKGRAY);
+            if (resumable) drawTextLine(resumeText, DARKGRAY);
             EndDrawing();
 
             if (IsKeyPressed(KEY_ENTER)) {
                 gameState = PLAYING;
-                train       = Train(gridWidth / 2, gridHeight / 2);
-                dirX = 1; dirY = 0;
-                cargoX = rand() % gridWidth;
-                cargoY = rand() % gridHeight;
-                level  = 1;
-                speed  = 5.0f;
-                timer  = 0.0f;
-                walls.clear();
+                seed = (uint64_t)std::time(nullptr);
+                sim.reset(seed);
+                beginReplay(replay, sim, seed);
+                shakeRng.reseed(~seed);
+                autopilot.clear();
+                initSnapshotRing(rewind, rewindTicks);
+                clearParticles(particles);
+                saveReplays = true;
+                resumable = nullptr;            // its file is about to be overwritten
+                resumeTick = 0;
+                clearInputQueue(turns);
+                timer = 0.0f;
+            } else if (resumable && IsKeyPressed(KEY_R) && restoreSnapshot(sim, resumable, restoreScratch)) {
+                gameState = PLAYING;
+                seed = (uint64_t)std::time(nullptr);
+                beginReplay(replay, sim, seed);
+                shakeRng.reseed(~seed);
+                autopilot.clear();
+                initSnapshotRing(rewind, rewindTicks);
+                clearParticles(particles);
+                saveReplays = false;
+                resumeTick = 0;
+                clearInputQueue(turns);
+                timer = resumable->timer;
+                resumable = nullptr;
             }
             break;
         }
@@ -139,115 +207,201 @@ int main() {
         case PLAYING: {
             timer += deltaTime;
 
-            if (IsKeyPressed(KEY_RIGHT) && !(dirX == -1 && dirY == 0)) { dirX = 1; dirY = 0; }
-            else if (IsKeyPressed(KEY_LEFT)  && !(dirX == 1 && dirY == 0)) { dirX = -1; dirY = 0; }
-            else if (IsKeyPressed(KEY_UP)    && !(dirX == 0 && dirY == 1)) { dirX = 0; dirY = -1; }
-            else if (IsKeyPressed(KEY_DOWN)  && !(dirX == 0 && dirY == -1)) { dirX = 0; dirY = 1; }
-
-            if (timer >= 1.0f / speed) {
-                timer = 0.0f;
-
-                int newX = (train.head->x + dirX + gridWidth)  % gridWidth;
-                int newY = (train.head->y + dirY + gridHeight) % gridHeight;
-
-                if (train.isOnPosition(newX, newY)) {
-                    gameState = GAME_OVER;
-                    break;
-                }
-                // ---- brick-wall collision ----
-                bool hitWall = false;
-                for (const Wall& w : walls) {
-                    if (newX == w.x && newY == w.y) { hitWall = true; break; }
+            // holding BACKSPACE steps back one tick per frame
+            bool rewinding = IsKeyDown(KEY_BACKSPACE);
+            if (rewinding) rewindTick();
+
+            {
+                ProfileScope scope(PHASE_INPUT);
+                // presses queued before a switch are stale either way
+                if (IsKeyPressed(KEY_A)) { autopilotOn = !autopilotOn; clearInputQueue(turns); }
+                // every press since the last frame, in order; the autopilot
+                // steers per tick in the loop below
+                for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed()) {
+                    if (autopilotOn) continue;
+                    if (key == KEY_RIGHT)     pushTurn(turns,  1,  0, now, sim.dirX, sim.dirY);
+                    else if (key == KEY_LEFT) pushTurn(turns, -1,  0, now, sim.dirX, sim.dirY);
+                    else if (key == KEY_UP)   pushTurn(turns,  0, -1, now, sim.dirX, sim.dirY);
+                    else if (key == KEY_DOWN) pushTurn(turns,  0,  1, now, sim.dirX, sim.dirY);
                 }
-                if (hitWall) {
-                    stripLastCarriage(train);
-                    shakeTime = 0.4f;
-                }
-                train.move(newX, newY);
-
-                if (newX == cargoX && newY == cargoY) {
-                    train.addCarriage();
-                    level++;
-                    speed = fminf(speed + 0.5f, 12.0f);
-                    spawnWalls(level, gridWidth, gridHeight, train, cargoX, cargoY);
-                    placeCargo(cargoX, cargoY, train, gridWidth, gridHeight); // ignore result
+            }
+
+            // fixed-step simulation: run as many ticks as the elapsed time
+            // covers and carry the remainder over to the next frame
+            {
+                ProfileScope scope(PHASE_TICK);
+                int ticks = 0;
+                while (!rewinding && timer >= 1.0f / sim.speed) {
+                    timer -= 1.0f / sim.speed;
+
+                    SimInput input = autopilotOn ? autopilot.next(sim) : nextTurn(turns, now);
+                    pushSnapshot(rewind, sim, timer, replay.ticks);
+                    recordTick(replay, sim, input);
+                    TickEvents events = sim.step(input);
+                    if (events.crashed) {
+                        finishReplay(replay, sim);
+                        if (saveReplays)
+                            saveReplay(replay, TextFormat("replay_%llu.tgr", (unsigned long long)seed));
+                        remove(RESUME_PATH);
+                        gameState = GAME_OVER;
+                        break;
+                    }
+                    if (events.hitWall) {
+                        shakeTime = 0.4f;
+                        emitAtHead(EFFECT_DEBRIS, 24);
+                    }
+                    if (events.pickedCargo) emitAtHead(EFFECT_CARGO, 32);
+                    // a backlog past the cap is dropped, but never the
+                    // partial tick that only drives interpolation
+                    if (++ticks == MAX_TICKS_PER_FRAME) { timer = fminf(timer, 1.0f / sim.speed); break; }
                 }
             }
+            if (gameState != PLAYING) break;
+            // once per frame at most, after the ticks, so a slow disk never
+            // holds up the fixed step
+            if (snapshots && replay.ticks >= resumeTick + RESUME_EVERY_TICKS) {
+                resumeTick = replay.ticks;
+                takeSnapshot(resumeBlob, sim, timer, replay.ticks);
+                saveSnapshot(resumeBlob, RESUME_PATH);
+            }
+            float alpha = fminf(timer * sim.speed, 1.0f);
 
             // ----------  DRAW  ----------
+            if (!hugeWorld) {
+                ProfileScope scope(PHASE_PLAYFIELD);
+                syncPlayfield(playfield, sim.walls);
+            }
+            {
+                ProfileScope scope(PHASE_HUD);
+                syncHud(hud, sim.level, sim.train.length(), autopilotOn);
+            }
             BeginDrawing();
             // camera shake
+            Vector2 shake = { 0, 0 };
             if (shakeTime > 0.0f) {
-                float sx = GetRandomValue(-100, 100) / 100.0f * shakeIntensity;
-                float sy = GetRandomValue(-100, 100) / 100.0f * shakeIntensity;
-                BeginMode2D((Camera2D){ {0,0}, {sx, sy}, 0.0f, 1.0f });
+                shake.x = (shakeRng.below(201) - 100) / 100.0f * shakeIntensity;
+                shake.y = (shakeRng.below(201) - 100) / 100.0f * shakeIntensity;
                 shakeTime -= deltaTime;
-            } else {
-                BeginMode2D((Camera2D){ {0,0}, {0,0}, 0.0f, 1.0f });
+            }
+            Camera2D screenCamera = { shake, {0,0}, 0.0f, 1.0f };
+            Camera2D worldCamera = screenCamera;
+            if (hugeWorld) {
+                followTrain(view, sim.train, alpha, screenWidth, screenHeight, shake);
+                worldCamera = view.camera;
             }
 
             ClearBackground({135, 206, 235, 255});
-            drawHills(screenWidth, screenHeight, time);
-            drawClouds(screenWidth, screenHeight, time);
-
-            int trainLength = 0;
-            for (TrainCarriage* cur = train.head; cur != nullptr; cur = cur->next) trainLength++;
-
-            Rectangle levelBox  = {10, 10, 120, 40};
-            DrawRectangleRounded(levelBox, 0.2f, 6, BLUE);
-            DrawRectangleRoundedLines(levelBox, 0.2f, 6, DARKBLUE);
-            DrawText("Level", levelBox.x + 15, levelBox.y + 5, 18, WHITE);
-            DrawText(TextFormat("%d", level), levelBox.x + 15, levelBox.y + 22, 22, YELLOW);
-
-            Rectangle lengthBox = {140, 10, 140, 40};
-            DrawRectangleRounded(lengthBox, 0.2f, 6, BLUE);
-            DrawRectangleRoundedLines(lengthBox, 0.2f, 6, DARKBLUE);
-            DrawText("Length", lengthBox.x + 15, lengthBox.y + 5, 18, WHITE);
-            DrawText(TextFormat("%d", trainLength), lengthBox.x + 15, lengthBox.y + 22, 22, YELLOW);
-
-            Rectangle instrBox  = {300, 10, screenWidth - 310, 40};
-            DrawRectangleRounded(instrBox, 0.2f, 6, GRAY);
-            DrawRectangleRoundedLines(instrBox, 0.2f, 6, DARKGRAY);
-            DrawText("Use arrow keys to drive the train", instrBox.x + 15, instrBox.y + 12, 20, BLACK);
-
-            drawTrainTracks(gridWidth, gridHeight, cellSize, topBarHeight);
-            drawCargo(cargoX, cargoY, cellSize, topBarHeight);
-            for (const Wall& w : walls) drawBrickWall(w.x, w.y, cellSize, topBarHeight);
-            drawTrain(train, cellSize, topBarHeight, dirX, dirY);
+            BeginMode2D(screenCamera);
+            {
+                ProfileScope scope(PHASE_BACKGROUND);
+                drawParallax(background, screenWidth, time);
+            }
+            // on the fixed board the locomotive may overlap the top bar, in
+            // a scrolling world the top bar covers the world
+            if (!hugeWorld) {
+                ProfileScope scope(PHASE_HUD);
+                drawHud(hud);
+            }
+            submitPass();
+            EndMode2D();
 
+            BeginMode2D(worldCamera);
+            {
+                ProfileScope scope(PHASE_PLAYFIELD);
+                if (hugeWorld) {
+                    drawWorldTracks(view);
+                    drawWorldWalls(view, atlas, sim.walls);
+                } else {
+                    drawPlayfield(playfield, topBarHeight);
+                }
+            }
+            {
+                ProfileScope scope(PHASE_CARGO);
+                if (hugeWorld) drawWorldCargo(view, atlas, sim.cargoX, sim.cargoY);
+                else drawSprite(atlas, SPRITE_CARGO, sim.cargoX * cellSize, sim.cargoY * cellSize + offsetY);
+            }
+            {
+                ProfileScope scope(PHASE_TRAIN);
+                if (hugeWorld) drawWorldTrain(view, atlas, sim.train, sim.dirX, sim.dirY, alpha, time);
+                else drawTrain(atlas, sim.train, cellSize, topBarHeight, sim.dirX, sim.dirY, alpha, time);
+            }
+            {
+                ProfileScope scope(PHASE_EFFECTS);
+                int px, py;
+                carriagePosition(sim.train, 0, cellSize, offsetY, alpha, px, py);
+                if (hugeWorld) { px = (int)view.locomotive.x; py = (int)view.locomotive.y; }
+                for (smokeClock += deltaTime; smokeClock >= SMOKE_INTERVAL; smokeClock -= SMOKE_INTERVAL)
+                    emitParticles(particles, EFFECT_SMOKE, px + cellSize * 0.5f, py - 4.0f, 1);
+                updateParticles(particles, deltaTime);
+                if (hugeWorld)
+                    drawParticles(atlas, particles, (float)gridWidth * cellSize, (float)gridHeight * cellSize,
+                                  view.camera.target);
+                else
+                    drawParticles(atlas, particles);
+            }
+            submitPass();
             EndMode2D();
-            EndDrawing();
+
+            if (hugeWorld) {
+                BeginMode2D(screenCamera);
+                {
+                    ProfileScope scope(PHASE_HUD);
+                    drawHud(hud);
+                }
+                submitPass();
+                EndMode2D();
+            }
+
+            if (profiler.overlay) {
+                float meanMs, maxMs;
+                inputLatency(turns, meanMs, maxMs);
+                DrawText(TextFormat("input to tick %.1f ms mean, %.1f ms max, %d dropped", meanMs, maxMs, turns.dropped),
+                         10, screenHeight - 206, 10, DARKGRAY);
+                DrawText(TextFormat("render %d commands, %d draw calls, %d vertices", renderList.frame.commands,
+                                    renderList.frame.drawCalls, renderList.frame.vertices),
+                         10, screenHeight - 220, 10, DARKGRAY);
+                drawProfilerOverlay(10, screenHeight - 190);
+            }
+            {
+                ProfileScope scope(PHASE_PRESENT);
+                EndDrawing();
+            }
             break;
         }
 
         case GAME_OVER: {
             BeginDrawing();
             ClearBackground({135, 206, 235, 255});
-            drawHills(screenWidth, screenHeight, time);
-            drawClouds(screenWidth, screenHeight, time);
-
-            DrawText("GAME OVER", GetScreenWidth()/2 - MeasureText("GAME OVER", 60)/2 + 3, GetScreenHeight()/2 - 45 + 3, 60, Fade(RED, 0.6f));
-            DrawText("GAME OVER", GetScreenWidth()/2 - MeasureText("GAME OVER", 60)/2, GetScreenHeight()/2 - 45, 60, RED);
-            DrawText("Press ENTER to Restart", GetScreenWidth()/2 - MeasureText("Press ENTER to Restart", 24)/2 + 1, GetScreenHeight()/2 + 20 + 1, 24, Fade(DARKGRAY, 0.5f));
-            DrawText("Press ENTER to Restart", GetScreenWidth()/2 - MeasureText("Press ENTER to Restart", 24)/2, GetScreenHeight()/2 + 20, 24, DARKGRAY);
+            drawParallax(background, screenWidth, time);
+            submitRenderList();
+
+            drawTextLine(gameOverText, Fade(RED, 0.6f), 3, 3);
+            drawTextLine(gameOverText, RED);
+            drawTextLine(restartText, Fade(DARKGRAY, 0.5f), 1, 1);
+            drawTextLine(restartText, DARKGRAY);
+            if (rewind.count > 0) drawTextLine(rewindText, DARKGRAY);
             EndDrawing();
 
-            if (IsKeyPressed(KEY_ENTER)) {
-                train  = Train(gridWidth / 2, gridHeight / 2);
-                dirX   = 1; dirY = 0;
-                cargoX = rand() % gridWidth;
-                cargoY = rand() % gridHeight;
-                level  = 1;
-                speed  = 5.0f;
-                timer  = 0.0f;
-                walls.clear();
+            if (IsKeyPressed(KEY_BACKSPACE) && rewindTick()) {
+                gameState = PLAYING;
+            } else if (IsKeyPressed(KEY_ENTER)) {
+                sim.reset(seed);
+                clearInputQueue(turns);
+                timer = 0.0f;
                 gameState = START_MENU;
             }
             break;
         }
         } // switch
+        endProfileFrame();
     }     // while window open
 
+    stopProfileCsv();
+    unloadHud(hud);
+    unloadParallax(background);
+    if (hugeWorld) unloadWorldView(view);
+    else unloadPlayfield(playfield);
+    unloadSpriteAtlas(atlas);
     CloseWindow();
     return 0;
 }
\ No newline at end of file
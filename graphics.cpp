@@ -1,52 +1,42 @@
 #include "graphics.h"
-#include "train.h"
 #include <cmath>
-#include <cstdlib>
-#include <vector>
 
-void drawSmoke(int x, int y) {
-    float t = GetTime() * 2;
-    for (int i = 0; i < 5; i++) {
-        float offsetY = fmod(t * 40 + i * 30, 60);
-        float alpha = 0.5f - (offsetY / 60.0f);
-        float radius = 6.0f - (offsetY / 15.0f);
-        DrawCircleGradient(x + 10 + (sin(t + i) * 4), y - offsetY, radius,
-                           Fade(LIGHTGRAY, alpha), Fade(WHITE, 0));
-    }
-}
-
-void drawHills(int screenWidth, int screenHeight, float time) {
+void loadBackground(std::vector<ParallaxLayer>& layers, int screenWidth, int screenHeight, float resolution) {
     Color hillColors[3] = { {50, 100, 30, 255}, {30, 80, 20, 255}, {20, 60, 15, 255} };
     int hillHeights[3] = { 150, 100, 70 };
     float hillSpeeds[3] = { 10.0f, 20.0f, 40.0f };
+    int step = 100;
 
     for (int layer = 0; layer < 3; layer++) {
-        float offset = fmod(time * hillSpeeds[layer], screenWidth + 200);
-        int baseY = screenHeight - hillHeights[layer];
-        int step = 100;
-
-        for (int x = -200; x < screenWidth + 200; x += step) {
-            int hillPeakX = (int)(x - offset);
-            Vector2 points[3] = {
-                { (float)(hillPeakX), (float)(baseY) },
-                { (float)(hillPeakX + step / 2), (float)(baseY - hillHeights[layer]) },
-                { (float)(hillPeakX + step), (float)(baseY) }
-            };
-            DrawTriangle(points[0], points[1], points[2], hillColors[layer]);
-        }
+        int h = hillHeights[layer];
+        int baseY = screenHeight - h;
+        beginParallaxLayer(layers, step, h, baseY - h, -hillSpeeds[layer], 0.0f, resolution);
+        Vector2 points[3] = {
+            { 0.0f, (float)h },
+            { (float)(step / 2), 0.0f },
+            { (float)step, (float)h }
+        };
+        DrawTriangle(points[0], points[1], points[2], hillColors[layer]);
+        endParallaxLayer();
     }
-}
 
-void drawClouds(int screenWidth, int screenHeight, float time) {
+    // clouds wrap every screenWidth + 200 pixels; paint the neighbouring
+    // periods too so puffs straddling the seam are not cut off
     float cloudSpeed = 30.0f;
     int cloudY = screenHeight / 4;
-
+    float period = screenWidth + 200;
+    int top = cloudY - 40;
+    beginParallaxLayer(layers, period, 4 * 30 + 90, top, cloudSpeed, 200.0f, resolution);
     for (int i = 0; i < 5; i++) {
-        float cloudX = fmod(time * cloudSpeed + i * 150, screenWidth + 200) - 200;
-        DrawEllipse((int)(cloudX), cloudY + i * 30, 60, 30, Fade(WHITE, 0.8f));
-        DrawEllipse((int)(cloudX + 30), cloudY + i * 30 + 10, 70, 35, Fade(WHITE, 0.7f));
-        DrawEllipse((int)(cloudX + 60), cloudY + i * 30, 50, 25, Fade(WHITE, 0.8f));
+        for (float wrap = -period; wrap <= period; wrap += period) {
+            int cloudX = (int)(i * 150 + wrap);
+            int y = cloudY + i * 30 - top;
+            DrawEllipse(cloudX, y, 60, 30, Fade(WHITE, 0.8f));
+            DrawEllipse(cloudX + 30, y + 10, 70, 35, Fade(WHITE, 0.7f));
+            DrawEllipse(cloudX + 60, y, 50, 25, Fade(WHITE, 0.8f));
+        }
     }
+    endParallaxLayer();
 }
 
 void DrawRectangleVGradient(int x, int y, int width, int height, Color top, Color bottom) {
@@ -62,65 +52,53 @@ void DrawRectangleVGradient(int x, int y, int width, int height, Color top, Colo
     }
 }
 
-void drawTrain(Train& train, int cellSize, int offsetY, int dirX, int dirY) {
-    TrainCarriage* current = train.head;
-    int index = 0;
-
-    float wheelRotation = GetTime() * 12.0f;
-
-    while (current != nullptr) {
-        int px = current->x * cellSize;
-        int py = current->y * cellSize + offsetY;
-
-        DrawCircle(px + cellSize / 2, py + cellSize - 3, cellSize / 3, Fade(BLACK, 0.2f));
-
-        if (index == 0) {
-            DrawRectangleVGradient(px, py, cellSize, cellSize, DARKBLUE, (Color){ 30, 60, 140, 255 });
-            DrawRectangleVGradient(px + cellSize / 4, py + cellSize / 4, cellSize / 2, cellSize / 3, SKYBLUE, (Color){ 100, 180, 255, 255 });
-            drawSmoke(px + cellSize / 2, py);
-
-            Color noseColor = (Color){ 20, 40, 90, 255 };
-            if (dirX == 1)
-                DrawTriangle((Vector2){(float)(px + cellSize), (float)py},
-                             (Vector2){(float)(px + cellSize), (float)(py + cellSize)},
-                             (Vector2){(float)(px + cellSize + 6), (float)(py + cellSize / 2)}, noseColor);
-            else if (dirX == -1)
-                DrawTriangle((Vector2){(float)px, (float)py},
-                             (Vector2){(float)px, (float)(py + cellSize)},
-                             (Vector2){(float)(px - 6), (float)(py + cellSize / 2)}, noseColor);
-            else if (dirY == -1)
-                DrawTriangle((Vector2){(float)px, (float)py},
-                             (Vector2){(float)(px + cellSize), (float)py},
-                             (Vector2){(float)(px + cellSize / 2), (float)(py - 6)}, noseColor);
-            else if (dirY == 1)
-                DrawTriangle((Vector2){(float)px, (float)(py + cellSize)},
-                             (Vector2){(float)(px + cellSize), (float)(py + cellSize)},
-                             (Vector2){(float)(px + cellSize / 2), (float)(py + cellSize + 6)}, noseColor);
-
-            DrawRectangle(px + cellSize / 2 - 3, py - 6, 6, 6, (Color){ 50, 80, 140, 255 });
-        } else {
-            DrawRectangleVGradient(px + 2, py + 4, cellSize - 4, cellSize - 8, BLUE, (Color){ 20, 50, 130, 255 });
-
-            Vector2 center1 = { (float)(px + 6), (float)(py + cellSize - 3) };
-            Vector2 center2 = { (float)(px + cellSize - 6), (float)(py + cellSize - 3) };
-            int wheelRadius = 4;
-
-            for (int i = 0; i < 4; i++) {
-                float angle = wheelRotation + i * 3.14159f / 2;
-                Vector2 offset = { cosf(angle) * wheelRadius, sinf(angle) * wheelRadius };
-                DrawLineEx(center1, (Vector2){center1.x + offset.x, center1.y + offset.y}, 2, BLACK);
-                DrawLineEx(center2, (Vector2){center2.x + offset.x, center2.y + offset.y}, 2, BLACK);
-            }
-
-            DrawCircle(center1.x, center1.y, wheelRadius, DARKGRAY);
-            DrawCircle(center2.x, center2.y, wheelRadius, DARKGRAY);
-            DrawCircleLines(center1.x, center1.y, wheelRadius, BLACK);
-            DrawCircleLines(center2.x, center2.y, wheelRadius, BLACK);
-        }
+void drawLocomotive(int px, int py, int cellSize, int dirX, int dirY) {
+    DrawCircle(px + cellSize / 2, py + cellSize - 3, cellSize / 3, Fade(BLACK, 0.2f));
+
+    DrawRectangleVGradient(px, py, cellSize, cellSize, DARKBLUE, (Color){ 30, 60, 140, 255 });
+    DrawRectangleVGradient(px + cellSize / 4, py + cellSize / 4, cellSize / 2, cellSize / 3, SKYBLUE, (Color){ 100, 180, 255, 255 });
+
+    Color noseColor = (Color){ 20, 40, 90, 255 };
+    if (dirX == 1)
+        DrawTriangle((Vector2){(float)(px + cellSize), (float)py},
+                     (Vector2){(float)(px + cellSize), (float)(py + cellSize)},
+                     (Vector2){(float)(px + cellSize + 6), (float)(py + cellSize / 2)}, noseColor);
+    else if (dirX == -1)
+        DrawTriangle((Vector2){(float)px, (float)py},
+                     (Vector2){(float)px, (float)(py + cellSize)},
+                     (Vector2){(float)(px - 6), (float)(py + cellSize / 2)}, noseColor);
+    else if (dirY == -1)
+        DrawTriangle((Vector2){(float)px, (float)py},
+                     (Vector2){(float)(px + cellSize), (float)py},
+                     (Vector2){(float)(px + cellSize / 2), (float)(py - 6)}, noseColor);
+    else if (dirY == 1)
+        DrawTriangle((Vector2){(float)px, (float)(py + cellSize)},
+                     (Vector2){(float)(px + cellSize), (float)(py + cellSize)},
+                     (Vector2){(float)(px + cellSize / 2), (float)(py + cellSize + 6)}, noseColor);
+
+    DrawRectangle(px + cellSize / 2 - 3, py - 6, 6, 6, (Color){ 50, 80, 140, 255 });
+}
+
+void drawCarriage(int px, int py, int cellSize, float wheelRotation) {
+    DrawCircle(px + cellSize / 2, py + cellSize - 3, cellSize / 3, Fade(BLACK, 0.2f));
+
+    DrawRectangleVGradient(px + 2, py + 4, cellSize - 4, cellSize - 8, BLUE, (Color){ 20, 50, 130, 255 });
+
+    Vector2 center1 = { (float)(px + 6), (float)(py + cellSize - 3) };
+    Vector2 center2 = { (float)(px + cellSize - 6), (float)(py + cellSize - 3) };
+    int wheelRadius = 4;
 
-        current = current->next;
-        index++;
+    for (int i = 0; i < 4; i++) {
+        float angle = wheelRotation + i * 3.14159f / 2;
+        Vector2 offset = { cosf(angle) * wheelRadius, sinf(angle) * wheelRadius };
+        DrawLineEx(center1, (Vector2){center1.x + offset.x, center1.y + offset.y}, 2, BLACK);
+        DrawLineEx(center2, (Vector2){center2.x + offset.x, center2.y + offset.y}, 2, BLACK);
     }
+
+    DrawCircle(center1.x, center1.y, wheelRadius, DARKGRAY);
+    DrawCircle(center2.x, center2.y, wheelRadius, DARKGRAY);
+    DrawCircleLines(center1.x, center1.y, wheelRadius, BLACK);
+    DrawCircleLines(center2.x, center2.y, wheelRadius, BLACK);
 }
 
 void drawTrainTracks(int gridWidth, int gridHeight, int cellSize, int offsetY) {
@@ -145,9 +123,28 @@ void drawTrainTracks(int gridWidth, int gridHeight, int cellSize, int offsetY) {
     }
 }
 
-void drawCargo(int cargoX, int cargoY, int cellSize, int offsetY) {
-    int x = cargoX * cellSize;
-    int y = cargoY * cellSize + offsetY;
+void drawBrickWall(int px, int py, int cellSize) {
+    Color mortar = { 160, 82, 45, 255 };   // brownish
+    DrawRectangle(px, py, cellSize, cellSize, mortar);
+
+    int rows = 4;
+    int rowH = cellSize / rows;
+    for (int r = 0; r < rows; ++r) {
+        bool oddRow = (r & 1);
+        int bricksPerRow = 3;
+        int brickW = cellSize / bricksPerRow;
+        for (int b = 0; b < bricksPerRow; ++b) {
+            int bx = px + b * brickW + (oddRow ? brickW / 2 : 0);
+            int by = py + r * rowH;
+            Color brick = { 178, 34, 34, 255 };  // red brick
+            DrawRectangle(bx, by, brickW - 2, rowH - 2, brick);
+            DrawRectangle(bx, by, brickW - 2, 2, { 200, 70, 70, 255 }); // highlight
+        }
+    }
+    DrawRectangleLines(px, py, cellSize, cellSize, DARKBROWN);
+}
+
+void drawCargo(int x, int y, int cellSize) {
 
     DrawRectangleVGradient(x, y, cellSize, cellSize, ORANGE, (Color){ 190, 120, 30, 255 });
     DrawRectangleLines(x, y, cellSize, cellSize, (Color){ 120, 70, 15, 255 });
@@ -160,24 +157,3 @@ void drawCargo(int cargoX, int cargoY, int cellSize, int offsetY) {
     DrawCircle(x + 4, y + cellSize - 4, 2, BLACK);
     DrawCircle(x + cellSize - 4, y + cellSize - 4, 2, BLACK);
 }
-
-bool placeCargo(int& cargoX, int& cargoY, Train& train, int gridWidth, int gridHeight) {
-    std::vector<std::pair<int,int>> freeSpots;
-
-    for (int x = 0; x < gridWidth; x++) {
-        for (int y = 0; y < gridHeight; y++) {
-            if (!train.isOnPosition(x, y)) {
-                freeSpots.emplace_back(x, y);
-            }
-        }
-    }
-
-    if (freeSpots.empty()) {
-        return false;  // no place for cargo, game over condition
-    }
-
-    int idx = rand() % freeSpots.size();
-    cargoX = freeSpots[idx].first;
-    cargoY = freeSpots[idx].second;
-    return true;
-}
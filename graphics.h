@@ -1,13 +1,19 @@
 #pragma once
 #include "raylib.h"
-#include "train.h"
+#include "parallax.h"
+#include <vector>
 
-void drawSmoke(int x, int y);
-void drawHills(int screenWidth, int screenHeight, float time);
-void drawClouds(int screenWidth, int screenHeight, float time);
+// Immediate-mode drawing, used to bake the atlas, playfield and background
+// textures; per-frame drawing is recorded by scene.h.
+
+// Bakes the three hill layers and the cloud layer; resolution < 1 trades
+// background sharpness for texture memory.
+void loadBackground(std::vector<ParallaxLayer>& layers, int screenWidth, int screenHeight, float resolution);
 void DrawRectangleVGradient(int x, int y, int width, int height, Color top, Color bottom);
 
-void drawTrain(Train& train, int cellSize, int offsetY, int dirX, int dirY);
+void drawLocomotive(int px, int py, int cellSize, int dirX, int dirY);
+void drawCarriage(int px, int py, int cellSize, float wheelRotation);
 void drawTrainTracks(int gridWidth, int gridHeight, int cellSize, int offsetY);
-void drawCargo(int cargoX, int cargoY, int cellSize, int offsetY);
+void drawCargo(int x, int y, int cellSize);
+void drawBrickWall(int px, int py, int cellSize);
 
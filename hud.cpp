@@ -0,0 +1,98 @@
+#include "hud.h"
+#include "profiler.h"
+#include <algorithm>
+
+static const int HUD_HEIGHT = 60;
+
+static void renderHud(const Hud& hud) {
+    float width = (float)hud.target.texture.width;
+    BeginTextureMode(hud.target);
+    ClearBackground(BLANK);
+
+    Rectangle levelBox  = {10, 10, 120, 40};
+    DrawRectangleRounded(levelBox, 0.2f, 6, BLUE);
+    DrawRectangleRoundedLines(levelBox, 0.2f, 6, DARKBLUE);
+    DrawText("Level", levelBox.x + 15, levelBox.y + 5, 18, WHITE);
+    DrawText(TextFormat("%d", hud.level), levelBox.x + 15, levelBox.y + 22, 22, YELLOW);
+
+    Rectangle lengthBox = {140, 10, 140, 40};
+    DrawRectangleRounded(lengthBox, 0.2f, 6, BLUE);
+    DrawRectangleRoundedLines(lengthBox, 0.2f, 6, DARKBLUE);
+    DrawText("Length", lengthBox.x + 15, lengthBox.y + 5, 18, WHITE);
+    DrawText(TextFormat("%d", (int)hud.length), lengthBox.x + 15, lengthBox.y + 22, 22, YELLOW);
+
+    Rectangle instrBox  = {300, 10, width - 310, 40};
+    DrawRectangleRounded(instrBox, 0.2f, 6, GRAY);
+    DrawRectangleRoundedLines(instrBox, 0.2f, 6, DARKGRAY);
+    DrawText(hud.autopilot ? "Autopilot driving - press A to take over" : "Use arrow keys to drive the train",
+             instrBox.x + 15, instrBox.y + 12, 20, BLACK);
+    EndTextureMode();
+    profileDraws(11);   // three boxes with outlines, five labels
+}
+
+Hud loadHud(int screenWidth) {
+    Hud hud;
+    hud.target = LoadRenderTexture(screenWidth, HUD_HEIGHT);
+    hud.level = -1;
+    hud.length = 0;
+    hud.autopilot = false;
+    return hud;
+}
+
+void unloadHud(Hud& hud) {
+    UnloadRenderTexture(hud.target);
+    hud.target = {};
+}
+
+void syncHud(Hud& hud, int level, std::size_t length, bool autopilot) {
+    if (hud.level == level && hud.length == length && hud.autopilot == autopilot) return;
+    hud.level = level;
+    hud.length = length;
+    hud.autopilot = autopilot;
+    renderHud(hud);
+}
+
+// ----------  STATIC TEXT  ----------
+TextLine centredText(const char* text, int fontSize, int screenWidth, int y) {
+    return { text, screenWidth / 2 - MeasureText(text, fontSize) / 2, y, fontSize };
+}
+
+void drawTextLine(const TextLine& line, Color color, int dx, int dy) {
+    DrawText(line.text, line.x + dx, line.y + dy, line.fontSize, color);
+}
+
+// ----------  PROFILER OVERLAY  ----------
+void drawProfilerOverlay(int x, int y) {
+    int frames = std::min(profiler.frame, PROFILE_HISTORY);
+    if (frames == 0) return;
+    int last = (profiler.frame - 1) % PROFILE_HISTORY;
+
+    const int lineH = 14;
+    const int columns[5] = { 6, 90, 145, 200, 255 };
+    DrawRectangle(x, y, 310, (PHASE_COUNT + 3) * lineH + 8, Fade(BLACK, 0.7f));
+    const char* headers[5] = { "phase", "p50", "p99", "max", "draws" };
+    for (int c = 0; c < 5; c++) DrawText(headers[c], x + columns[c], y + 4, 10, YELLOW);
+
+    float sorted[PROFILE_HISTORY];
+    int totalDraws = 0;
+    for (int p = 0; p <= PHASE_COUNT; p++) {
+        std::copy(profiler.ms[p], profiler.ms[p] + frames, sorted);
+        std::sort(sorted, sorted + frames);
+        float p50 = sorted[frames / 2];
+        float p99 = sorted[std::min(frames - 1, frames * 99 / 100)];
+        float max = sorted[frames - 1];
+
+        int draws = totalDraws;
+        if (p < PHASE_COUNT) totalDraws += draws = profiler.draws[p][last];
+
+        int ly = y + 4 + (p + 1) * lineH;
+        Color color = p < PHASE_COUNT ? WHITE : YELLOW;
+        DrawText(p < PHASE_COUNT ? profilePhaseNames[p] : "frame", x + columns[0], ly, 10, color);
+        DrawText(TextFormat("%.2f", p50), x + columns[1], ly, 10, color);
+        DrawText(TextFormat("%.2f", p99), x + columns[2], ly, 10, color);
+        DrawText(TextFormat("%.2f", max), x + columns[3], ly, 10, color);
+        DrawText(TextFormat("%d", draws), x + columns[4], ly, 10, color);
+    }
+    DrawText(TextFormat("ms over %d frames - F3 overlay, F4 csv%s", frames, profiler.csv ? " (rec)" : ""),
+             x + columns[0], y + 4 + (PHASE_COUNT + 2) * lineH, 10, LIGHTGRAY);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+
+// The top bar (level, length and instruction boxes) is kept in a render
+// texture and redrawn only when one of the values shown changes; every
+// other frame it is a single blit.
+struct Hud {
+    RenderTexture2D target;
+    int level;                          // values baked in; -1 forces a redraw
+    std::size_t length;
+    bool autopilot;
+};
+
+Hud loadHud(int screenWidth);
+void unloadHud(Hud& hud);
+// Re-renders the bar if any value differs from the baked one. Call outside
+// BeginDrawing.
+void syncHud(Hud& hud, int level, std::size_t length, bool autopilot);
+
+// A string that never changes, measured once and centred on the screen.
+struct TextLine {
+    const char* text;
+    int x, y;
+    int fontSize;
+};
+
+TextLine centredText(const char* text, int fontSize, int screenWidth, int y);
+void drawTextLine(const TextLine& line, Color color, int dx = 0, int dy = 0);
+
+// ----------  PROFILER OVERLAY  ----------
+// p50 / p99 / max per profiler phase and last frame's draw counts,
+// top-left at (x, y).
+void drawProfilerOverlay(int x, int y);
@@ -0,0 +1,42 @@
+#include "inputqueue.h"
+#include <algorithm>
+
+void clearInputQueue(InputQueue& queue) {
+    queue.first = queue.count = 0;
+    queue.dropped = 0;
+    queue.applied = 0;
+}
+
+bool pushTurn(InputQueue& queue, int turnX, int turnY, double time, int dirX, int dirY) {
+    if (queue.count > 0) {
+        const QueuedTurn& last = queue.turns[(queue.first + queue.count - 1) % INPUT_QUEUE_CAPACITY];
+        dirX = last.dirX;
+        dirY = last.dirY;
+    }
+    if ((turnX == dirX && turnY == dirY) || (turnX == -dirX && turnY == -dirY)) return false;
+    if (queue.count == INPUT_QUEUE_CAPACITY) { queue.dropped++; return false; }
+
+    queue.turns[(queue.first + queue.count) % INPUT_QUEUE_CAPACITY] = { turnX, turnY, time };
+    queue.count++;
+    return true;
+}
+
+SimInput nextTurn(InputQueue& queue, double time) {
+    if (queue.count == 0) return { 0, 0 };
+    const QueuedTurn& turn = queue.turns[queue.first];
+    queue.first = (queue.first + 1) % INPUT_QUEUE_CAPACITY;
+    queue.count--;
+    queue.latencyMs[queue.applied % INPUT_LATENCY_HISTORY] = (float)((time - turn.time) * 1000.0);
+    queue.applied++;
+    return { turn.dirX, turn.dirY };
+}
+
+void inputLatency(const InputQueue& queue, float& meanMs, float& maxMs) {
+    int n = std::min(queue.applied, INPUT_LATENCY_HISTORY);
+    meanMs = maxMs = 0.0f;
+    for (int i = 0; i < n; i++) {
+        meanMs += queue.latencyMs[i];
+        maxMs = std::max(maxMs, queue.latencyMs[i]);
+    }
+    if (n > 0) meanMs /= n;
+}
@@ -0,0 +1,40 @@
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include "sim.h"
+
+const int INPUT_QUEUE_CAPACITY = 4;     // turns buffered ahead of the train
+const int INPUT_LATENCY_HISTORY = 64;
+
+// Direction presses in the order they were made, consumed one per tick, so
+// two presses between ticks (UP then LEFT for a tight turn) both take
+// effect on consecutive ticks instead of the last one winning. A press is
+// checked against the heading the train will have once the turns ahead of
+// it are applied: repeats and reversals of that heading are dropped here
+// rather than wasting a tick in GameSim::step.
+struct QueuedTurn {
+    int dirX, dirY;
+    double time;                        // seconds, when the press was seen
+};
+
+struct InputQueue {
+    QueuedTurn turns[INPUT_QUEUE_CAPACITY];
+    int first, count;
+    int dropped;                        // presses lost to a full queue
+
+    // press-to-tick latency of the last applied turns, milliseconds
+    float latencyMs[INPUT_LATENCY_HISTORY];
+    int applied;
+};
+
+void clearInputQueue(InputQueue& queue);
+// Queues a turn pressed at `time` while the train heads (dirX, dirY);
+// false if it was dropped.
+bool pushTurn(InputQueue& queue, int turnX, int turnY, double time, int dirX, int dirY);
+// Input for the tick run at `time`: the oldest pending turn, or {0, 0}.
+SimInput nextTurn(InputQueue& queue, double time);
+
+// Mean and worst latency over the recent history; 0 if nothing applied yet.
+void inputLatency(const InputQueue& queue, float& meanMs, float& maxMs);
+
+#endif
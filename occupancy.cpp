@@ -0,0 +1,11 @@
+#include "occupancy.h"
+#include <algorithm>
+
+OccupancyGrid::OccupancyGrid(int width, int height)
+    : width(width), height(height), cells(width, height),
+      chunkUse((size_t)cells.chunksX * cells.chunksY, 0) {}
+
+void OccupancyGrid::clear() {
+    cells.clear();
+    std::fill(chunkUse.begin(), chunkUse.end(), 0);
+}
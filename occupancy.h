@@ -0,0 +1,49 @@
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include "chunkgrid.h"
+#include <cstdint>
+#include <vector>
+
+// Per-cell counter over the play grid. Counts rather than flags, because a
+// freshly added carriage shares its cell with the tail until the next move.
+// Stored in chunks, and a chunk is released once its last carriage leaves,
+// so a huge world only pays for the area the train covers right now.
+// Each cell also keeps a caller-supplied stamp of when it was last entered.
+class OccupancyGrid {
+public:
+    OccupancyGrid(int width, int height);
+
+    void add(int x, int y) {
+        cells.at(x, y).count++;
+        chunkUse[cells.chunkOf(x, y)]++;
+    }
+    void remove(int x, int y) {
+        Cell& cell = cells.at(x, y);
+        if (--cell.count == 0) cell.entered = 0;
+        int chunk = cells.chunkOf(x, y);
+        if (--chunkUse[chunk] == 0) cells.release(chunk);
+    }
+    void enter(int x, int y, uint32_t stamp) {
+        Cell& cell = cells.at(x, y);
+        cell.count++;
+        cell.entered = stamp;
+        chunkUse[cells.chunkOf(x, y)]++;
+    }
+    bool isOccupied(int x, int y) const { return cells.get(x, y).count != 0; }
+    uint32_t enteredAt(int x, int y) const { return cells.get(x, y).entered; }
+    bool chunkEmpty(int cx, int cy) const { return cells.chunkEmpty(cx, cy); }
+    void clear();
+
+    int width, height;
+
+private:
+    struct Cell {
+        uint32_t entered;
+        uint16_t count;
+    };
+    ChunkedGrid<Cell> cells;
+    std::vector<uint32_t> chunkUse;     // carriages per chunk
+};
+
+#endif
@@ -0,0 +1,37 @@
+#include "parallax.h"
+#include "rlgl.h"
+#include <cmath>
+
+void beginParallaxLayer(std::vector<ParallaxLayer>& layers, float period, float height, float y,
+                        float velocity, float phase, float resolution) {
+    ParallaxLayer layer;
+    layer.period     = period;
+    layer.height     = height;
+    layer.y          = y;
+    layer.velocity   = velocity;
+    layer.phase      = phase;
+    layer.resolution = resolution;
+    layer.strip = LoadRenderTexture((int)ceilf(period * resolution), (int)ceilf(height * resolution));
+    SetTextureWrap(layer.strip.texture, TEXTURE_WRAP_REPEAT);
+    SetTextureFilter(layer.strip.texture, resolution == 1.0f ? TEXTURE_FILTER_POINT : TEXTURE_FILTER_BILINEAR);
+    layers.push_back(layer);
+
+    BeginTextureMode(layer.strip);
+    ClearBackground(BLANK);
+    // accumulate coverage in alpha so the strip comes out premultiplied
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                              RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    BeginMode2D((Camera2D){ {0, 0}, {0, 0}, 0.0f, resolution });
+}
+
+void endParallaxLayer() {
+    EndMode2D();
+    EndBlendMode();
+    EndTextureMode();
+}
+
+void unloadParallax(std::vector<ParallaxLayer>& layers) {
+    for (ParallaxLayer& layer : layers) UnloadRenderTexture(layer.strip);
+    layers.clear();
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+
+// A background layer baked once into a horizontally tileable strip. Each
+// frame it is drawn as a single quad whose source rectangle scrolls over
+// the repeating texture, however much geometry went into the strip.
+struct ParallaxLayer {
+    RenderTexture2D strip;
+    float period;        // tile width in screen pixels
+    float height;
+    float y;             // screen y of the strip's top edge
+    float velocity;      // screen pixels per second, positive = rightwards
+    float phase;         // strip x shown at the left screen edge at time 0
+    float resolution;    // strip texels per screen pixel
+};
+
+// Starts baking a new layer: until endParallaxLayer(), draw one period of
+// the layer in strip coordinates, i.e. (0, 0) .. (period, height).
+void beginParallaxLayer(std::vector<ParallaxLayer>& layers, float period, float height, float y,
+                        float velocity, float phase, float resolution);
+void endParallaxLayer();
+
+void unloadParallax(std::vector<ParallaxLayer>& layers);
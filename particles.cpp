@@ -0,0 +1,111 @@
+#include "particles.h"
+#include <algorithm>
+#include <cmath>
+
+struct EffectStyle {
+    float speedMin, speedMax;
+    float spread;                       // radians around the base direction
+    float baseX, baseY;                 // used when the caller gives no direction
+    float gravity, drag;
+    float lifeMin, lifeMax;
+    float size0, size1;
+    uint32_t colors[2];                 // picked at random per particle
+};
+
+static const EffectStyle EFFECT_STYLES[EFFECT_COUNT] = {
+    // smoke: slow, drifting up, growing as it fades
+    { 25.0f,  45.0f, 0.5f, 0.0f, -1.0f,  -10.0f, 0.6f, 1.0f, 1.6f,  6.0f, 16.0f,
+      { 0xD3D3D380u, 0xF5F5F570u } },
+    // debris: thrown forward and falling
+    { 80.0f, 220.0f, 1.4f, 0.0f, -1.0f,  420.0f, 1.2f, 0.5f, 0.9f,  4.0f,  3.0f,
+      { 0xB22222FFu, 0xA0522DFFu } },
+    // cargo: a ring of sparks all round
+    { 60.0f, 160.0f, 3.1416f, 0.0f, -1.0f,  60.0f, 2.5f, 0.4f, 0.7f,  5.0f,  1.0f,
+      { 0xFFCB00FFu, 0xFFA100FFu } },
+};
+
+static float uniform(Rng& rng, float lo, float hi) {
+    return lo + (hi - lo) * (rng.next() * (1.0f / 4294967296.0f));
+}
+
+void initParticles(ParticlePool& pool, int capacity, uint64_t seed) {
+    pool.capacity = capacity;
+    pool.count = 0;
+    for (std::vector<float>* v : { &pool.x, &pool.y, &pool.vx, &pool.vy, &pool.gravity, &pool.drag,
+                                   &pool.age, &pool.life, &pool.size0, &pool.size1 })
+        v->assign(capacity, 0.0f);
+    pool.color.assign(capacity, 0);
+    pool.effect.assign(capacity, 0);
+    pool.rng.reseed(seed);
+}
+
+void clearParticles(ParticlePool& pool) {
+    pool.count = 0;
+}
+
+void emitParticles(ParticlePool& pool, ParticleEffect effect, float x, float y, int count,
+                   float dirX, float dirY) {
+    const EffectStyle& style = EFFECT_STYLES[effect];
+    if (dirX == 0.0f && dirY == 0.0f) { dirX = style.baseX; dirY = style.baseY; }
+    float base = atan2f(dirY, dirX);
+
+    count = std::min(count, pool.capacity - pool.count);
+    for (int k = 0; k < count; k++) {
+        int i = pool.count++;
+        float angle = base + uniform(pool.rng, -style.spread, style.spread);
+        float speed = uniform(pool.rng, style.speedMin, style.speedMax);
+        pool.x[i]  = x;
+        pool.y[i]  = y;
+        pool.vx[i] = cosf(angle) * speed;
+        pool.vy[i] = sinf(angle) * speed;
+        pool.gravity[i] = style.gravity;
+        pool.drag[i]    = style.drag;
+        pool.age[i]  = 0.0f;
+        pool.life[i] = uniform(pool.rng, style.lifeMin, style.lifeMax);
+        pool.size0[i] = style.size0;
+        pool.size1[i] = style.size1;
+        pool.color[i] = style.colors[pool.rng.next() & 1];
+        pool.effect[i] = (uint8_t)effect;
+    }
+}
+
+void updateParticles(ParticlePool& pool, float dt) {
+    int n = pool.count;
+    float* x  = pool.x.data();
+    float* y  = pool.y.data();
+    float* vx = pool.vx.data();
+    float* vy = pool.vy.data();
+    float* age = pool.age.data();
+    const float* gravity = pool.gravity.data();
+    const float* drag    = pool.drag.data();
+
+    // branch-free integration over every live particle
+    for (int i = 0; i < n; i++) {
+        float keep = std::max(0.0f, 1.0f - drag[i] * dt);
+        vx[i] = vx[i] * keep;
+        vy[i] = vy[i] * keep + gravity[i] * dt;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        age[i] += dt;
+    }
+
+    // then drop the expired ones, moving the last live particle into the gap
+    const float* life = pool.life.data();
+    for (int i = 0; i < n;) {
+        if (age[i] < life[i]) { i++; continue; }
+        n--;
+        pool.x[i]  = pool.x[n];
+        pool.y[i]  = pool.y[n];
+        pool.vx[i] = pool.vx[n];
+        pool.vy[i] = pool.vy[n];
+        pool.gravity[i] = pool.gravity[n];
+        pool.drag[i]    = pool.drag[n];
+        pool.age[i]  = pool.age[n];
+        pool.life[i] = pool.life[n];
+        pool.size0[i] = pool.size0[n];
+        pool.size1[i] = pool.size1[n];
+        pool.color[i] = pool.color[n];
+        pool.effect[i] = pool.effect[n];
+    }
+    pool.count = n;
+}
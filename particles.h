@@ -0,0 +1,41 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "rng.h"
+#include <cstdint>
+#include <vector>
+
+enum ParticleEffect {
+    EFFECT_SMOKE,                       // soft puffs rising from the chimney
+    EFFECT_DEBRIS,                      // brick chips when a wall is hit
+    EFFECT_CARGO,                       // sparks when cargo is picked up
+    EFFECT_COUNT
+};
+
+const int PARTICLE_CAPACITY = 4096;
+
+// Fixed-capacity particle pool, one array per attribute so the update loop
+// runs straight down contiguous floats and the compiler can vectorize it.
+// Live particles are kept packed in [0, count): a dead one is replaced by
+// the last. Nothing is allocated after initParticles; emitting into a full
+// pool drops the new particles. Positions are in world pixels.
+struct ParticlePool {
+    int capacity, count;
+    std::vector<float> x, y, vx, vy;
+    std::vector<float> gravity, drag;   // pixels / s^2, fraction of speed lost per s
+    std::vector<float> age, life;       // seconds
+    std::vector<float> size0, size1;    // diameter at birth and at death
+    std::vector<uint32_t> color;        // 0xRRGGBBAA at birth; alpha fades to 0
+    std::vector<uint8_t> effect;
+    Rng rng;                            // own stream, never the simulation's
+};
+
+void initParticles(ParticlePool& pool, int capacity, uint64_t seed);
+// `count` particles of one effect at (x, y); (dirX, dirY) biases debris
+// towards the direction of travel.
+void emitParticles(ParticlePool& pool, ParticleEffect effect, float x, float y, int count,
+                   float dirX = 0.0f, float dirY = 0.0f);
+void updateParticles(ParticlePool& pool, float dt);
+void clearParticles(ParticlePool& pool);
+
+#endif
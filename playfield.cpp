@@ -0,0 +1,81 @@
+#include "playfield.h"
+#include "graphics.h"
+
+static void renderCell(const Playfield& playfield, int gx, int gy) {
+    int cs = playfield.cellSize;
+    int px = gx * cs;
+    int py = gy * cs + playfield.margin;
+
+    BeginScissorMode(px, py, cs, cs);
+    ClearBackground(BLANK);
+    drawTrainTracks(playfield.gridWidth, playfield.gridHeight, cs, playfield.margin);
+    if (playfield.wallCells[gy * playfield.gridWidth + gx])
+        drawBrickWall(px, py, cs);
+    EndScissorMode();
+}
+
+static void renderAll(Playfield& playfield) {
+    BeginTextureMode(playfield.target);
+    ClearBackground(BLANK);
+    drawTrainTracks(playfield.gridWidth, playfield.gridHeight, playfield.cellSize, playfield.margin);
+    for (const Wall& w : playfield.drawnWalls)
+        drawBrickWall(w.x * playfield.cellSize, w.y * playfield.cellSize + playfield.margin, playfield.cellSize);
+    EndTextureMode();
+}
+
+Playfield loadPlayfield(int gridWidth, int gridHeight, int cellSize) {
+    Playfield playfield;
+    playfield.target = {};
+    playfield.gridWidth = playfield.gridHeight = playfield.cellSize = 0;
+    playfield.margin = 8;
+    playfield.wallGeneration = 0;
+    resizePlayfield(playfield, gridWidth, gridHeight, cellSize);
+    return playfield;
+}
+
+void unloadPlayfield(Playfield& playfield) {
+    UnloadRenderTexture(playfield.target);
+    playfield.target = {};
+}
+
+void resizePlayfield(Playfield& playfield, int gridWidth, int gridHeight, int cellSize) {
+    if (playfield.gridWidth == gridWidth && playfield.gridHeight == gridHeight &&
+        playfield.cellSize == cellSize)
+        return;
+
+    if (playfield.target.id != 0) UnloadRenderTexture(playfield.target);
+    playfield.gridWidth  = gridWidth;
+    playfield.gridHeight = gridHeight;
+    playfield.cellSize   = cellSize;
+    playfield.target = LoadRenderTexture(gridWidth * cellSize + playfield.margin,
+                                         gridHeight * cellSize + 2 * playfield.margin);
+    playfield.wallCells.assign((size_t)gridWidth * gridHeight, 0);
+    playfield.drawnWalls.clear();
+    renderAll(playfield);
+}
+
+void setPlayfieldWall(Playfield& playfield, int gx, int gy, bool wall) {
+    uint8_t& cell = playfield.wallCells[gy * playfield.gridWidth + gx];
+    if (cell == (uint8_t)wall) return;
+    cell = wall;
+
+    BeginTextureMode(playfield.target);
+    renderCell(playfield, gx, gy);
+    EndTextureMode();
+}
+
+void syncPlayfield(Playfield& playfield, const WallSet& walls) {
+    std::vector<Wall>& drawn = playfield.drawnWalls;
+    if (walls.generation() != playfield.wallGeneration) {
+        // walls that survived stay baked; setPlayfieldWall skips them below
+        for (const Wall& w : drawn)
+            if (!walls.contains(w.x, w.y)) setPlayfieldWall(playfield, w.x, w.y, false);
+        drawn.clear();
+        playfield.wallGeneration = walls.generation();
+    }
+    const std::vector<Wall>& list = walls.list();
+    for (size_t i = drawn.size(); i < list.size(); i++) {
+        setPlayfieldWall(playfield, list[i].x, list[i].y, true);
+        drawn.push_back(list[i]);
+    }
+}
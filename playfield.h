@@ -0,0 +1,27 @@
+#pragma once
+#include "raylib.h"
+#include "walls.h"
+#include <cstdint>
+#include <vector>
+
+// Tracks and walls never move, so they are kept in a render texture and
+// blitted each frame. Wall changes re-render only the cells involved; the
+// whole layer is redrawn only when the grid or cell size changes.
+struct Playfield {
+    RenderTexture2D target;
+    int gridWidth, gridHeight, cellSize;
+    int margin;                         // ties overhang the grid edge
+    std::vector<uint8_t> wallCells;     // walls currently baked in
+    std::vector<Wall> drawnWalls;       // in the order they were synced
+    uint32_t wallGeneration;            // WallSet generation drawnWalls came from
+};
+
+Playfield loadPlayfield(int gridWidth, int gridHeight, int cellSize);
+void unloadPlayfield(Playfield& playfield);
+void resizePlayfield(Playfield& playfield, int gridWidth, int gridHeight, int cellSize);
+
+void setPlayfieldWall(Playfield& playfield, int gx, int gy, bool wall);
+// Bakes walls added since the last call; if the set was cleared since
+// (restart, rewind), first clears the cells of the walls that are gone.
+// Call outside BeginDrawing.
+void syncPlayfield(Playfield& playfield, const WallSet& walls);
@@ -0,0 +1,50 @@
+#include "profiler.h"
+
+Profiler profiler = {};
+
+const char* const profilePhaseNames[PHASE_COUNT] = {
+    "input", "tick", "background", "hud", "playfield", "cargo", "train", "effects", "present"
+};
+
+void beginProfileFrame() {
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        profiler.currentMs[p] = 0.0;
+        profiler.currentDraws[p] = 0;
+    }
+    profiler.active = PHASE_COUNT;
+    profiler.frameStart = ProfileClock::now();
+}
+
+void endProfileFrame() {
+    std::chrono::duration<double, std::milli> total = ProfileClock::now() - profiler.frameStart;
+    int slot = profiler.frame % PROFILE_HISTORY;
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        profiler.ms[p][slot] = (float)profiler.currentMs[p];
+        profiler.draws[p][slot] = profiler.currentDraws[p];
+    }
+    profiler.ms[PHASE_COUNT][slot] = (float)total.count();
+
+    if (profiler.csv) {
+        fprintf(profiler.csv, "%d,%.4f", profiler.frame, total.count());
+        for (int p = 0; p < PHASE_COUNT; p++) fprintf(profiler.csv, ",%.4f", profiler.currentMs[p]);
+        for (int p = 0; p < PHASE_COUNT; p++) fprintf(profiler.csv, ",%d", profiler.currentDraws[p]);
+        fputc('\n', profiler.csv);
+    }
+    profiler.frame++;
+}
+
+bool startProfileCsv(const char* path) {
+    stopProfileCsv();
+    profiler.csv = fopen(path, "w");
+    if (!profiler.csv) return false;
+    fprintf(profiler.csv, "frame,frame_ms");
+    for (int p = 0; p < PHASE_COUNT; p++) fprintf(profiler.csv, ",%s_ms", profilePhaseNames[p]);
+    for (int p = 0; p < PHASE_COUNT; p++) fprintf(profiler.csv, ",%s_draws", profilePhaseNames[p]);
+    fputc('\n', profiler.csv);
+    return true;
+}
+
+void stopProfileCsv() {
+    if (profiler.csv) fclose(profiler.csv);
+    profiler.csv = nullptr;
+}
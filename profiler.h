@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+// Lightweight per-phase frame timing. Wrap a phase in a ProfileScope; the
+// scopes of one phase add up within a frame. The last PROFILE_HISTORY
+// frames are kept for the overlay's rolling percentiles, and every frame can
+// optionally be appended to a CSV file. This part needs no raylib; the
+// overlay is drawn by the HUD (hud.h).
+enum ProfilePhase {
+    PHASE_INPUT,
+    PHASE_TICK,
+    PHASE_BACKGROUND,   // drawParallax: hills and clouds
+    PHASE_HUD,
+    PHASE_PLAYFIELD,    // syncPlayfield + drawPlayfield: tracks and walls
+    PHASE_CARGO,
+    PHASE_TRAIN,        // drawTrain
+    PHASE_EFFECTS,      // particle update and draw
+    PHASE_PRESENT,      // submitRenderList + EndDrawing: batch flush, swap, vsync wait
+    PHASE_COUNT
+};
+
+const int PROFILE_HISTORY = 240;
+
+typedef std::chrono::steady_clock ProfileClock;
+
+struct Profiler {
+    float ms[PHASE_COUNT + 1][PROFILE_HISTORY];     // last row is the whole frame
+    int draws[PHASE_COUNT][PROFILE_HISTORY];
+    int frame;                                      // frames recorded so far
+    int active;                                     // phase that draws are charged to
+
+    double currentMs[PHASE_COUNT];
+    int currentDraws[PHASE_COUNT];
+    ProfileClock::time_point frameStart;
+
+    bool overlay;
+    FILE* csv;
+};
+
+extern Profiler profiler;
+extern const char* const profilePhaseNames[PHASE_COUNT];
+
+void beginProfileFrame();
+void endProfileFrame();
+
+// Draw helpers report the primitives they submit; they are charged to the
+// innermost open ProfileScope (or dropped outside of one).
+inline void profileDraws(int count) {
+    if (profiler.active < PHASE_COUNT) profiler.currentDraws[profiler.active] += count;
+}
+
+struct ProfileScope {
+    ProfilePhase phase;
+    int outer;
+    ProfileClock::time_point start;
+
+    explicit ProfileScope(ProfilePhase phase)
+        : phase(phase), outer(profiler.active), start(ProfileClock::now()) {
+        profiler.active = phase;
+    }
+    ~ProfileScope() {
+        std::chrono::duration<double, std::milli> elapsed = ProfileClock::now() - start;
+        profiler.currentMs[phase] += elapsed.count();
+        profiler.active = outer;
+    }
+};
+
+bool startProfileCsv(const char* path);
+void stopProfileCsv();
@@ -0,0 +1,29 @@
+#include "render.h"
+#include "rlgl.h"
+
+RenderStats submitRenderList() {
+    RenderStats stats = sortRenderList(renderList);
+    int blend = -1;
+    for (const RenderCommand& c : renderList.commands) {
+        if (c.blend != blend) {
+            BeginBlendMode(c.blend == RENDER_BLEND_PREMULTIPLIED ? BLEND_ALPHA_PREMULTIPLY : BLEND_ALPHA);
+            blend = c.blend;
+        }
+        // consecutive commands with the same texture and mode extend raylib's
+        // current draw call instead of starting a new one
+        rlCheckRenderBatchLimit(4);
+        rlSetTexture(c.texture);
+        rlBegin(RL_QUADS);
+        rlColor4ub(c.color.r, c.color.g, c.color.b, c.color.a);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        rlTexCoord2f(c.u0, c.v0); rlVertex2f(c.x0, c.y0);
+        rlTexCoord2f(c.u0, c.v1); rlVertex2f(c.x0, c.y1);
+        rlTexCoord2f(c.u1, c.v1); rlVertex2f(c.x1, c.y1);
+        rlTexCoord2f(c.u1, c.v0); rlVertex2f(c.x1, c.y0);
+        rlEnd();
+    }
+    rlSetTexture(0);
+    if (blend >= 0) EndBlendMode();
+    clearRenderList(renderList);
+    return stats;
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include "raylib.h"
+#include "renderlist.h"
+
+// Sorts renderList, draws it under the current camera and clears it. Call
+// before the camera or render target changes.
+RenderStats submitRenderList();
@@ -0,0 +1,124 @@
+// Headless draw budget check: plays games with the autopilot at 60 frames a
+// second and records every frame into the render list as the game does,
+// the background pass (parallax and HUD) and the world pass (playfield,
+// cargo, train, particles), but never opens a window or submits anything.
+// Only raylib's header is needed, for the helpers' types; text is drawn
+// straight through raylib and is not counted. Build without raylib:
+//   g++ -O2 -std=c++17 rendercheck.cpp scene.cpp renderlist.cpp particles.cpp profiler.cpp
+//       sim.cpp train.cpp occupancy.cpp freecells.cpp walls.cpp connectivity.cpp
+//       autopilot.cpp -o rendercheck
+// Usage: rendercheck [--frames N] [--max-draws N] [--max-vertices N]
+// Exit status is non-zero if any frame goes over a limit.
+#include "sim.h"
+#include "autopilot.h"
+#include "scene.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    long frames = 20000;
+    int maxDraws = 0, maxVertices = 0;          // 0: no limit
+    for (int i = 1; i < argc; i += 2) {
+        // a flag missing its value is a usage error, not a dropped limit
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value && std::strcmp(argv[i], "--frames") == 0) frames = std::atol(value);
+        else if (value && std::strcmp(argv[i], "--max-draws") == 0) maxDraws = std::atoi(value);
+        else if (value && std::strcmp(argv[i], "--max-vertices") == 0) maxVertices = std::atoi(value);
+        else {
+            fprintf(stderr, "usage: %s [--frames N] [--max-draws N] [--max-vertices N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // the game's 800x600 board; textures only need ids and sizes here
+    const int screenWidth = 800, screenHeight = 600;
+    const int cellSize = 20, gridWidth = 40, gridHeight = 27, topBarHeight = 60;
+    std::vector<ParallaxLayer> background;
+    const float hillHeights[3] = { 150, 100, 70 }, hillSpeeds[3] = { 10, 20, 40 };
+    for (int i = 0; i < 4; i++) {
+        // three hill strips and the clouds, as loadBackground bakes them
+        ParallaxLayer layer = {};
+        layer.period     = i < 3 ? 100.0f : screenWidth + 200.0f;
+        layer.height     = i < 3 ? hillHeights[i] : 210.0f;
+        layer.y          = i < 3 ? screenHeight - 2 * hillHeights[i] : screenHeight / 4 - 40.0f;
+        layer.velocity   = i < 3 ? -hillSpeeds[i] : 30.0f;
+        layer.phase      = i < 3 ? 0.0f : 200.0f;
+        layer.resolution = 1.0f;
+        layer.strip.texture = { (unsigned)(10 + i), (int)layer.period, (int)layer.height, 1, 7 };
+        background.push_back(layer);
+    }
+    Hud hud = {};
+    hud.target.texture = { 3, screenWidth, topBarHeight, 1, 7 };
+    SpriteAtlas atlas = {};
+    atlas.cellSize = cellSize;
+    atlas.pad      = 8;
+    atlas.slot     = cellSize + 2 * atlas.pad;
+    atlas.columns  = 8;
+    atlas.target.texture = { 1, atlas.columns * atlas.slot, 2 * atlas.slot, 1, 7 };
+    Playfield playfield = {};
+    playfield.margin = 8;
+    playfield.target.texture = { 2, gridWidth * cellSize + 8, gridHeight * cellSize + 16, 1, 7 };
+
+    uint64_t seed = 1;
+    GameSim sim(gridWidth, gridHeight, seed);
+    Autopilot autopilot(gridWidth, gridHeight);
+    ParticlePool particles;
+    initParticles(particles, PARTICLE_CAPACITY, seed);
+
+    const float frameTime = 1.0f / 60.0f, smokeInterval = 0.05f;
+    float timer = 0.0f, smokeClock = 0.0f;
+    RenderStats worst = { 0, 0, 0 };
+    long over = 0, games = 1;
+    double drawSum = 0;
+
+    for (long frame = 0; frame < frames; frame++) {
+        timer += frameTime;
+        while (timer >= 1.0f / sim.speed) {
+            timer -= 1.0f / sim.speed;
+            TickEvents events = sim.step(autopilot.next(sim));
+            const TrainCarriage& head = sim.train.head();
+            float hx = (head.x + 0.5f) * cellSize, hy = (head.y + 0.5f) * cellSize + topBarHeight;
+            if (events.hitWall) emitParticles(particles, EFFECT_DEBRIS, hx, hy, 24, (float)sim.dirX, (float)sim.dirY);
+            if (events.pickedCargo) emitParticles(particles, EFFECT_CARGO, hx, hy, 32);
+            if (events.crashed) {
+                sim.reset(++seed);
+                autopilot.clear();
+                clearParticles(particles);
+                games++;
+            }
+        }
+        float alpha = timer * sim.speed;
+        float time = frame * frameTime;
+        renderList.frame = {};
+
+        drawParallax(background, screenWidth, time);
+        drawHud(hud);
+        sortRenderList(renderList);
+        clearRenderList(renderList);
+
+        drawPlayfield(playfield, topBarHeight);
+        drawSprite(atlas, SPRITE_CARGO, sim.cargoX * cellSize, sim.cargoY * cellSize + topBarHeight);
+        drawTrain(atlas, sim.train, cellSize, topBarHeight, sim.dirX, sim.dirY, alpha, time);
+        int px, py;
+        carriagePosition(sim.train, 0, cellSize, topBarHeight, alpha, px, py);
+        for (smokeClock += frameTime; smokeClock >= smokeInterval; smokeClock -= smokeInterval)
+            emitParticles(particles, EFFECT_SMOKE, px + cellSize * 0.5f, py - 4.0f, 1);
+        updateParticles(particles, frameTime);
+        drawParticles(atlas, particles);
+
+        sortRenderList(renderList);
+        clearRenderList(renderList);
+        RenderStats stats = renderList.frame;         // both passes
+        drawSum += stats.drawCalls;
+        if (stats.drawCalls > worst.drawCalls) worst.drawCalls = stats.drawCalls;
+        if (stats.vertices > worst.vertices) worst.vertices = stats.vertices;
+        if (stats.commands > worst.commands) worst.commands = stats.commands;
+        if ((maxDraws && stats.drawCalls > maxDraws) || (maxVertices && stats.vertices > maxVertices)) over++;
+    }
+
+    printf("%ld frames over %ld games: draw calls max %d mean %.2f, vertices max %d, commands max %d\n",
+           frames, games, worst.drawCalls, frames ? drawSum / frames : 0.0, worst.vertices, worst.commands);
+    if (over) printf("%ld frames over the limit\n", over);
+    return over ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+#include "renderlist.h"
+#include <algorithm>
+#include <cmath>
+
+RenderList renderList;
+
+static const bool LAYER_SORTED[LAYER_COUNT] = { false, false, false, true, true };
+
+void pushQuad(RenderList& list, RenderLayer layer, uint32_t texture, int textureWidth, int textureHeight,
+              const float source[4], const float dest[4], RenderColor tint, RenderBlend blend) {
+    uint64_t key = (uint64_t)layer << 60 | list.sequence++;
+    if (LAYER_SORTED[layer])
+        key |= (uint64_t)blend << 58 | (uint64_t)(texture & 0xFFFFFF) << 32;
+    list.commands.push_back(RenderCommand());
+    RenderCommand& c = list.commands.back();
+    c.key = key;
+    c.texture = texture;
+    c.blend = (uint8_t)blend;
+    c.color = tint;
+
+    float w = (float)textureWidth, h = (float)textureHeight;
+    c.u0 = source[0] / w;
+    c.v0 = source[1] / h;
+    c.u1 = (source[0] + fabsf(source[2])) / w;
+    c.v1 = (source[1] + fabsf(source[3])) / h;
+    if (source[2] < 0) std::swap(c.u0, c.u1);
+    if (source[3] < 0) std::swap(c.v0, c.v1);
+    c.x0 = dest[0];
+    c.y0 = dest[1];
+    c.x1 = dest[0] + dest[2];
+    c.y1 = dest[1] + dest[3];
+}
+
+RenderStats sortRenderList(RenderList& list) {
+    std::vector<RenderCommand>& commands = list.commands;
+    std::sort(commands.begin(), commands.end(),
+              [](const RenderCommand& a, const RenderCommand& b) { return a.key < b.key; });
+
+    RenderStats stats = { (int)commands.size(), 0, 0 };
+    int fill = RENDER_BATCH_VERTICES;   // forces a draw call for the first command
+    const RenderCommand* previous = nullptr;
+    for (const RenderCommand& c : commands) {
+        bool full = fill + 4 > RENDER_BATCH_VERTICES;
+        if (full) fill = 0;
+        if (full || c.texture != previous->texture || c.blend != previous->blend) stats.drawCalls++;
+        fill += 4;
+        stats.vertices += 4;
+        previous = &c;
+    }
+
+    list.frame.commands  += stats.commands;
+    list.frame.drawCalls += stats.drawCalls;
+    list.frame.vertices  += stats.vertices;
+    return stats;
+}
+
+void clearRenderList(RenderList& list) {
+    list.commands.clear();
+    list.sequence = 0;
+}
@@ -0,0 +1,69 @@
+#ifndef RENDERLIST_H
+#define RENDERLIST_H
+
+#include <cstdint>
+#include <vector>
+
+// Per-frame draw commands, recorded by the draw helpers (scene.h) and
+// submitted to raylib in one pass (render.h). Every command is a textured
+// quad. Commands go into layers that are drawn in order. Inside a sorted
+// layer they are stably ordered by GPU state (blend mode, texture) so that
+// commands sharing a state end up next to each other and form one batch;
+// only put things in a sorted layer whose relative order does not matter
+// between different states.
+// This part has no raylib dependency: recording and counting work without
+// a window, which is how rendercheck holds the draw-call budget.
+enum RenderLayer {
+    LAYER_BACKGROUND,                   // parallax strips, kept in order
+    LAYER_HUD,
+    LAYER_GROUND,                       // tracks and walls
+    LAYER_SPRITES,                      // cargo and train, sorted
+    LAYER_EFFECTS,                      // particles, sorted
+    LAYER_COUNT
+};
+
+enum RenderBlend { RENDER_BLEND_STRAIGHT, RENDER_BLEND_PREMULTIPLIED };
+
+// raylib's default batch holds this many quads; a longer run is split
+const int RENDER_BATCH_VERTICES = 8192 * 4;
+
+struct RenderColor {
+    uint8_t r, g, b, a;
+};
+
+struct RenderCommand {
+    uint64_t key;                       // layer, state and sequence: the sort order
+    uint32_t texture;
+    uint8_t blend;
+    RenderColor color;
+    float x0, y0, x1, y1;               // top-left and bottom-right
+    float u0, v0, u1, v1;               // texture coordinates, 0..1 per repeat
+};
+
+struct RenderStats {
+    int commands;
+    int drawCalls;                      // GPU state changes plus batch-full splits
+    int vertices;
+};
+
+struct RenderList {
+    std::vector<RenderCommand> commands;  // capacity kept between frames
+    uint32_t sequence;
+    RenderStats frame;                  // summed over the lists submitted this frame
+};
+
+// `source` is in texels (negative size flips, like raylib's source rects),
+// `dest` in pixels.
+void pushQuad(RenderList& list, RenderLayer layer, uint32_t texture, int textureWidth, int textureHeight,
+              const float source[4], const float dest[4], RenderColor tint,
+              RenderBlend blend = RENDER_BLEND_STRAIGHT);
+
+// Puts the commands in submission order and counts them as raylib would
+// batch them; the counts are also added to list.frame.
+RenderStats sortRenderList(RenderList& list);
+void clearRenderList(RenderList& list);
+
+// The list the draw helpers record into.
+extern RenderList renderList;
+
+#endif
@@ -0,0 +1,177 @@
+#include "replay.h"
+#include <cstdio>
+#include <cstring>
+
+static const uint8_t REPLAY_MAGIC[4] = { 'T', 'G', 'R', 'P' };
+// 3: walls that would cut the board apart are no longer spawned, so games
+// recorded by versions 1 and 2 play out differently and are rejected.
+static const uint8_t REPLAY_VERSION = 3;
+
+static const int8_t codeDirX[4] = { 1, -1, 0, 0 };
+static const int8_t codeDirY[4] = { 0, 0, -1, 1 };
+
+static uint32_t dirCode(int dirX, int dirY) {
+    if (dirX == 1)  return 0;
+    if (dirX == -1) return 1;
+    if (dirY == -1) return 2;
+    return 3;
+}
+
+void beginReplay(Replay& replay, const GameSim& sim, uint64_t seed) {
+    replay.seed       = seed;
+    replay.gridWidth  = sim.gridWidth;
+    replay.gridHeight = sim.gridHeight;
+    replay.inputs.clear();
+    replay.ticks      = 0;
+    replay.finalHash  = 0;
+    replay.checkpoints.clear();
+}
+
+void recordTick(Replay& replay, const GameSim& sim, SimInput input) {
+    if (replay.ticks % REPLAY_CHECKPOINT_TICKS == 0) replay.checkpoints.push_back(sim.stateHash());
+    if (input.dirX || input.dirY)
+        replay.inputs.push_back({ replay.ticks, (int8_t)input.dirX, (int8_t)input.dirY });
+    replay.ticks++;
+}
+
+void rewindReplay(Replay& replay, uint32_t tick) {
+    if (tick >= replay.ticks) return;
+    while (!replay.inputs.empty() && replay.inputs.back().tick >= tick) replay.inputs.pop_back();
+    replay.checkpoints.resize((tick + REPLAY_CHECKPOINT_TICKS - 1) / REPLAY_CHECKPOINT_TICKS);
+    replay.ticks = tick;
+}
+
+void finishReplay(Replay& replay, const GameSim& sim) {
+    replay.finalHash = sim.stateHash();
+}
+
+// ----------  ENCODING  ----------
+static void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) { out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    out.push_back((uint8_t)v);
+}
+
+static void putFixed(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok;
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) { ok = false; return 0; }
+            uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    uint64_t fixed(int bytes) {
+        if (end - p < bytes) { ok = false; return 0; }
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; i++) v |= (uint64_t)*p++ << (8 * i);
+        return v;
+    }
+};
+
+void encodeReplay(const Replay& replay, std::vector<uint8_t>& out) {
+    out.clear();
+    for (uint8_t b : REPLAY_MAGIC) out.push_back(b);
+    out.push_back(REPLAY_VERSION);
+    putFixed(out, replay.seed, 8);
+    putFixed(out, (uint64_t)replay.gridWidth, 2);
+    putFixed(out, (uint64_t)replay.gridHeight, 2);
+
+    putVarint(out, replay.inputs.size());
+    uint32_t lastTick = 0;
+    for (const ReplayInput& in : replay.inputs) {
+        putVarint(out, (uint64_t)(in.tick - lastTick) << 2 | dirCode(in.dirX, in.dirY));
+        lastTick = in.tick;
+    }
+    putVarint(out, replay.ticks);
+    putFixed(out, replay.finalHash, 8);
+    putVarint(out, replay.checkpoints.size());
+    for (uint64_t hash : replay.checkpoints) putFixed(out, hash, 8);
+}
+
+bool decodeReplay(Replay& replay, const uint8_t* data, size_t size) {
+    Reader in = { data, data + size, true };
+    if (size < 5 || std::memcmp(data, REPLAY_MAGIC, 4) != 0) return false;
+    in.p += 4;
+    uint64_t version = in.fixed(1);
+    if (version != REPLAY_VERSION) return false;
+
+    replay.seed       = in.fixed(8);
+    replay.gridWidth  = (int)in.fixed(2);
+    replay.gridHeight = (int)in.fixed(2);
+    // the sizes --world accepts; u16 already caps them at 65535
+    if (replay.gridWidth < 2 || replay.gridHeight < 2) return false;
+
+    uint64_t count = in.varint();
+    if (!in.ok || count > size) return false;  // every input takes at least a byte
+    replay.inputs.resize(count);
+    uint32_t tick = 0;
+    for (ReplayInput& r : replay.inputs) {
+        uint64_t v = in.varint();
+        tick += (uint32_t)(v >> 2);
+        r = { tick, codeDirX[v & 3], codeDirY[v & 3] };
+    }
+    replay.ticks     = (uint32_t)in.varint();
+    replay.finalHash = in.fixed(8);
+    uint64_t checkpoints = in.varint();
+    if (!in.ok || checkpoints > size / 8) return false;
+    replay.checkpoints.resize(checkpoints);
+    for (uint64_t& hash : replay.checkpoints) hash = in.fixed(8);
+    return in.ok && in.p == in.end;
+}
+
+bool saveReplay(const Replay& replay, const char* path) {
+    std::vector<uint8_t> bytes;
+    encodeReplay(replay, bytes);
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool loadReplay(Replay& replay, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof buffer, f)) > 0) bytes.insert(bytes.end(), buffer, buffer + n);
+    fclose(f);
+    return decodeReplay(replay, bytes.data(), bytes.size());
+}
+
+// ----------  PLAYBACK  ----------
+bool verifyReplay(const Replay& replay, GameSim& sim, uint32_t* divergedBy) {
+    if (sim.gridWidth != replay.gridWidth || sim.gridHeight != replay.gridHeight) return false;
+
+    sim.reset(replay.seed);
+    size_t next = 0;
+    for (uint32_t tick = 0; tick < replay.ticks; tick++) {
+        size_t checkpoint = tick / REPLAY_CHECKPOINT_TICKS;
+        if (tick % REPLAY_CHECKPOINT_TICKS == 0 && checkpoint < replay.checkpoints.size() &&
+            replay.checkpoints[checkpoint] != sim.stateHash()) {
+            if (divergedBy) *divergedBy = tick;
+            return false;
+        }
+        SimInput input = { 0, 0 };
+        if (next < replay.inputs.size() && replay.inputs[next].tick == tick) {
+            input = { replay.inputs[next].dirX, replay.inputs[next].dirY };
+            next++;
+        }
+        sim.step(input);
+    }
+    if (next == replay.inputs.size() && sim.stateHash() == replay.finalHash) return true;
+    if (divergedBy) *divergedBy = replay.ticks;
+    return false;
+}
@@ -0,0 +1,55 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "sim.h"
+#include <cstdint>
+#include <vector>
+
+// A game is fully determined by its seed and the steering input of each
+// tick, so that is all a replay stores. On disk:
+//   "TGRP" | version u8 | seed u64 | gridWidth u16 | gridHeight u16 |
+//   input count varint | per input: varint (ticks since previous << 2 | dir) |
+//   total ticks varint | final state hash u64 |
+//   checkpoint count varint | per checkpoint: state hash u64   (little endian)
+// where dir is 0 right, 1 left, 2 up, 3 down. Ticks without a turn cost
+// nothing and a turn usually takes one or two bytes. Checkpoints hash the
+// state before every REPLAY_CHECKPOINT_TICKS-th tick, so a divergence can be
+// pinned down to a stretch of ticks rather than "somewhere". Only the
+// current version is read: older replays ran under older game rules and
+// cannot be re-simulated.
+const uint32_t REPLAY_CHECKPOINT_TICKS = 256;
+
+struct ReplayInput {
+    uint32_t tick;
+    int8_t dirX, dirY;
+};
+
+struct Replay {
+    uint64_t seed;
+    int gridWidth, gridHeight;
+    std::vector<ReplayInput> inputs;
+    uint32_t ticks;
+    uint64_t finalHash;
+    std::vector<uint64_t> checkpoints;
+};
+
+void beginReplay(Replay& replay, const GameSim& sim, uint64_t seed);
+// Call with the input handed to every GameSim::step, in order, just before
+// the step.
+void recordTick(Replay& replay, const GameSim& sim, SimInput input);
+// Drops everything from `tick` on, after the game was rewound to that tick.
+void rewindReplay(Replay& replay, uint32_t tick);
+void finishReplay(Replay& replay, const GameSim& sim);
+
+void encodeReplay(const Replay& replay, std::vector<uint8_t>& out);
+bool decodeReplay(Replay& replay, const uint8_t* data, size_t size);
+bool saveReplay(const Replay& replay, const char* path);
+bool loadReplay(Replay& replay, const char* path);
+
+// Re-runs the recording on `sim` (which must match the replay's grid) and
+// compares the checkpoints and the final state hash. No rendering, no frame
+// pacing. On a mismatch, `divergedBy` (if given) gets the first tick at
+// which the state is known to differ.
+bool verifyReplay(const Replay& replay, GameSim& sim, uint32_t* divergedBy = nullptr);
+
+#endif
@@ -0,0 +1,45 @@
+// Headless replay verifier: re-runs every given replay at full speed and
+// checks its checkpoint and final state hashes. Build without raylib:
+//   g++ -O2 -std=c++17 replaycheck.cpp replay.cpp sim.cpp train.cpp occupancy.cpp
+//       freecells.cpp walls.cpp connectivity.cpp -o replaycheck
+// Exit status is non-zero if any replay fails to load or diverges.
+#include "replay.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s replay.tgr...\n", argv[0]);
+        return 2;
+    }
+
+    std::unique_ptr<GameSim> sim;
+    Replay replay;
+    int failed = 0;
+    unsigned long long ticks = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int i = 1; i < argc; i++) {
+        if (!loadReplay(replay, argv[i])) {
+            printf("%s: unreadable (or recorded by an older version)\n", argv[i]);
+            failed++;
+            continue;
+        }
+        // one simulator per grid size, reused across replays
+        if (!sim || sim->gridWidth != replay.gridWidth || sim->gridHeight != replay.gridHeight)
+            sim.reset(new GameSim(replay.gridWidth, replay.gridHeight, replay.seed));
+
+        uint32_t divergedBy = 0;
+        bool ok = verifyReplay(replay, *sim, &divergedBy);
+        ticks += replay.ticks;
+        if (!ok) {
+            printf("%s: MISMATCH (diverged by tick %u of %u)\n", argv[i], divergedBy, replay.ticks);
+            failed++;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%d/%d replays verified, %llu ticks in %.3f s\n", argc - 1 - failed, argc - 1, ticks, seconds);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,32 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// Small seedable generator (xorshift64*) so a game is fully determined by
+// its seed and does not share state with rand() or raylib.
+struct Rng {
+    uint64_t state;
+
+    explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        // splitmix64 step, so nearby seeds give unrelated streams
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        state = (z ^ (z >> 31)) | 1;
+    }
+
+    uint32_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return (uint32_t)((state * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+
+    // uniform in [0, n) without a division
+    int below(int n) { return (int)(((uint64_t)next() * (uint32_t)n) >> 32); }
+};
+
+#endif
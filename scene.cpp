@@ -0,0 +1,134 @@
+#include "scene.h"
+#include "profiler.h"
+#include <cmath>
+
+void queueTexture(RenderLayer layer, const Texture2D& texture, Rectangle source, Rectangle dest, Color tint,
+                  RenderBlend blend) {
+    const float src[4] = { source.x, source.y, source.width, source.height };
+    const float dst[4] = { dest.x, dest.y, dest.width, dest.height };
+    pushQuad(renderList, layer, texture.id, texture.width, texture.height, src, dst, { tint.r, tint.g, tint.b, tint.a }, blend);
+}
+
+// ----------  BACKGROUND AND HUD  ----------
+void drawParallax(const std::vector<ParallaxLayer>& layers, int screenWidth, float time) {
+    for (const ParallaxLayer& layer : layers) {
+        float x = fmodf(layer.phase - time * layer.velocity, layer.period);
+        // the repeat wrap mode tiles the strip across the whole screen width
+        Rectangle source = { x * layer.resolution, 0,
+                             screenWidth * layer.resolution, -layer.height * layer.resolution };
+        Rectangle dest = { 0, layer.y, (float)screenWidth, layer.height };
+        queueTexture(LAYER_BACKGROUND, layer.strip.texture, source, dest, WHITE, RENDER_BLEND_PREMULTIPLIED);
+    }
+    profileDraws((int)layers.size());
+}
+
+void drawHud(const Hud& hud) {
+    const Texture2D& texture = hud.target.texture;
+    queueTexture(LAYER_HUD, texture, (Rectangle){ 0, 0, (float)texture.width, (float)-texture.height },
+                 (Rectangle){ 0, 0, (float)texture.width, (float)texture.height }, WHITE);
+    profileDraws(1);
+}
+
+void drawPlayfield(const Playfield& playfield, int offsetY) {
+    const Texture2D& texture = playfield.target.texture;
+    queueTexture(LAYER_GROUND, texture, (Rectangle){ 0, 0, (float)texture.width, (float)-texture.height },
+                 (Rectangle){ 0, (float)(offsetY - playfield.margin), (float)texture.width, (float)texture.height },
+                 WHITE);
+    profileDraws(1);
+}
+
+// ----------  SPRITES  ----------
+int locomotiveSprite(int dirX, int dirY) {
+    if (dirX == -1) return SPRITE_LOCO_LEFT;
+    if (dirY == -1) return SPRITE_LOCO_UP;
+    if (dirY == 1)  return SPRITE_LOCO_DOWN;
+    return SPRITE_LOCO_RIGHT;
+}
+
+int wheelFrameAt(float wheelRotation) {
+    float quarterTurns = wheelRotation / (3.14159f / 2);
+    return (int)((quarterTurns - floorf(quarterTurns)) * WHEEL_FRAMES) % WHEEL_FRAMES;
+}
+
+void drawSprite(const SpriteAtlas& atlas, int sprite, int px, int py, RenderLayer layer) {
+    int x, y;
+    slotOrigin(atlas, sprite, x, y);
+    // render textures are stored bottom-up: flip the source rectangle
+    Rectangle source = { (float)x, (float)(atlas.target.texture.height - y - atlas.slot),
+                         (float)atlas.slot, (float)-atlas.slot };
+    Rectangle dest = { (float)(px - atlas.pad), (float)(py - atlas.pad), (float)atlas.slot, (float)atlas.slot };
+    queueTexture(layer, atlas.target.texture, source, dest, WHITE, RENDER_BLEND_PREMULTIPLIED);
+    profileDraws(1);
+}
+
+void drawSpriteScaled(const SpriteAtlas& atlas, int sprite, float cx, float cy, float size, Color tint,
+                      RenderLayer layer) {
+    int x, y;
+    slotOrigin(atlas, sprite, x, y);
+    float cs = (float)atlas.cellSize;
+    Rectangle source = { (float)(x + atlas.pad), (float)(atlas.target.texture.height - y - atlas.pad) - cs, cs, -cs };
+    Rectangle dest = { cx - size * 0.5f, cy - size * 0.5f, size, size };
+    Color premultiplied = { (unsigned char)(tint.r * tint.a / 255), (unsigned char)(tint.g * tint.a / 255),
+                            (unsigned char)(tint.b * tint.a / 255), tint.a };
+    queueTexture(layer, atlas.target.texture, source, dest, premultiplied, RENDER_BLEND_PREMULTIPLIED);
+}
+
+// ----------  TRAIN  ----------
+// Pixel position of a carriage `alpha` of the way from its previous cell.
+// A step across the wrap-around edge is not interpolated.
+static float lerpCell(int from, int to, float alpha) {
+    if (to - from > 1 || from - to > 1) return (float)to;
+    return from + (to - from) * alpha;
+}
+
+const TrainCarriage& previousCell(const Train& train, std::size_t index) {
+    const TrainCarriage& current = train[index];
+    // a fresh carriage shares its cell with the tail until the next move
+    bool follows = index + 1 < train.length() && (train[index + 1].x != current.x || train[index + 1].y != current.y);
+    return follows ? train[index + 1] : train.lastVacated();
+}
+
+void carriagePosition(const Train& train, std::size_t index, int cellSize, int offsetY, float alpha, int& px, int& py) {
+    const TrainCarriage& current = train[index];
+    const TrainCarriage& previous = previousCell(train, index);
+    px = (int)(lerpCell(previous.x, current.x, alpha) * cellSize);
+    py = (int)(lerpCell(previous.y, current.y, alpha) * cellSize) + offsetY;
+}
+
+void drawTrain(const SpriteAtlas& atlas, const Train& train, int cellSize, int offsetY, int dirX, int dirY,
+               float alpha, float time) {
+    int wheelFrame = wheelFrameAt(time * 12.0f);
+    std::size_t length = train.length();
+
+    for (std::size_t index = 0; index < length; index++) {
+        int px, py;
+        carriagePosition(train, index, cellSize, offsetY, alpha, px, py);
+        if (index == 0)
+            drawSprite(atlas, locomotiveSprite(dirX, dirY), px, py);
+        else
+            drawSprite(atlas, SPRITE_CARRIAGE + wheelFrame, px, py);
+    }
+}
+
+// ----------  PARTICLES  ----------
+static float nearestCopy(float v, float period, float centre) {
+    if (period <= 0.0f) return v;
+    return v + roundf((centre - v) / period) * period;
+}
+
+// All particles are quads from the sprite atlas, so raylib batches them
+// into one draw call however many are alive.
+void drawParticles(const SpriteAtlas& atlas, const ParticlePool& pool, float wrapWidth, float wrapHeight,
+                   Vector2 centre) {
+    static const int sprites[EFFECT_COUNT] = { SPRITE_PUFF, SPRITE_CHIP, SPRITE_PUFF };
+    for (int i = 0; i < pool.count; i++) {
+        float t = pool.age[i] / pool.life[i];
+        uint32_t c = pool.color[i];
+        Color tint = { (unsigned char)(c >> 24), (unsigned char)(c >> 16), (unsigned char)(c >> 8),
+                       (unsigned char)((c & 0xFF) * (1.0f - t)) };
+        float size = pool.size0[i] + (pool.size1[i] - pool.size0[i]) * t;
+        drawSpriteScaled(atlas, sprites[pool.effect[i]], nearestCopy(pool.x[i], wrapWidth, centre.x),
+                         nearestCopy(pool.y[i], wrapHeight, centre.y), size, tint);
+    }
+    profileDraws(pool.count);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "raylib.h"
+#include "atlas.h"
+#include "hud.h"
+#include "parallax.h"
+#include "particles.h"
+#include "playfield.h"
+#include "renderlist.h"
+#include "train.h"
+#include <vector>
+
+// Everything a frame draws on the fixed board, recorded into renderList.
+// These helpers only read the ids and sizes of textures that were baked
+// elsewhere and never call into raylib, so scene.cpp links without it:
+// rendercheck records whole frames headless with the same code the game
+// runs. Baking and submitting stay in the modules that own the textures.
+
+// Records a texture drawn as DrawTexturePro would (no rotation).
+void queueTexture(RenderLayer layer, const Texture2D& texture, Rectangle source, Rectangle dest, Color tint,
+                  RenderBlend blend = RENDER_BLEND_STRAIGHT);
+
+// ----------  BACKGROUND AND HUD  ----------
+void drawParallax(const std::vector<ParallaxLayer>& layers, int screenWidth, float time);
+void drawHud(const Hud& hud);
+void drawPlayfield(const Playfield& playfield, int offsetY);
+
+// ----------  SPRITES  ----------
+int locomotiveSprite(int dirX, int dirY);
+int wheelFrameAt(float wheelRotation);
+// (px, py) is the top-left corner of the cell, as for the immediate helpers
+void drawSprite(const SpriteAtlas& atlas, int sprite, int px, int py, RenderLayer layer = LAYER_SPRITES);
+// The cell part of a sprite scaled to `size` pixels around (cx, cy). `tint`
+// is straight alpha; it is premultiplied to match the atlas.
+void drawSpriteScaled(const SpriteAtlas& atlas, int sprite, float cx, float cy, float size, Color tint,
+                      RenderLayer layer = LAYER_EFFECTS);
+
+// ----------  TRAIN  ----------
+// The cell carriage `index` occupied one tick ago.
+const TrainCarriage& previousCell(const Train& train, std::size_t index);
+// Where carriage `index` is drawn, alpha in [0, 1] of the way from its
+// previous cell to its current one.
+void carriagePosition(const Train& train, std::size_t index, int cellSize, int offsetY, float alpha, int& px, int& py);
+// alpha in [0, 1] is how far the current tick has progressed; carriages are
+// drawn that far between their previous and current cells. `time` (seconds)
+// turns the wheels.
+void drawTrain(const SpriteAtlas& atlas, const Train& train, int cellSize, int offsetY, int dirX, int dirY,
+               float alpha, float time);
+
+// ----------  PARTICLES  ----------
+// On a wrapping world (wrapWidth, wrapHeight in pixels) each particle is
+// drawn at its copy nearest `centre`, so effects follow the view across
+// the seam.
+void drawParticles(const SpriteAtlas& atlas, const ParticlePool& pool, float wrapWidth = 0.0f,
+                   float wrapHeight = 0.0f, Vector2 centre = (Vector2){ 0, 0 });
@@ -0,0 +1,158 @@
+#include "sim.h"
+#include <cmath>
+#include <cstring>
+
+GameSim::GameSim(int gridWidth, int gridHeight, uint64_t seed)
+    : gridWidth(gridWidth), gridHeight(gridHeight),
+      sparse((int64_t)gridWidth * gridHeight > FREE_CELL_SET_LIMIT),
+      freeCells(sparse ? 0 : gridWidth, sparse ? 0 : gridHeight),
+      train(gridWidth / 2, gridHeight / 2, gridWidth, gridHeight),
+      walls(gridWidth, gridHeight), connectivity(gridWidth, gridHeight) {
+    reset(seed);
+}
+
+void GameSim::reset(uint64_t seed) {
+    rng.reseed(seed);
+    walls.clear();
+    freeCells.reset();
+    train = Train(gridWidth / 2, gridHeight / 2, gridWidth, gridHeight);
+    if (!sparse) train.trackFreeCells(&freeCells);
+    dirX = 1; dirY = 0;
+    cargoX = cargoY = -1;
+    level    = 1;
+    speed    = 5.0f;
+    gameOver = false;
+    placeCargo();
+}
+
+TickEvents GameSim::step(SimInput input) {
+    TickEvents events = { false, false, false };
+    if (gameOver) return events;
+
+    if ((input.dirX || input.dirY) && !(input.dirX == -dirX && input.dirY == -dirY)) {
+        dirX = input.dirX;
+        dirY = input.dirY;
+    }
+
+    int newX = (train.head().x + dirX + gridWidth)  % gridWidth;
+    int newY = (train.head().y + dirY + gridHeight) % gridHeight;
+
+    if (train.isOnPosition(newX, newY)) {
+        gameOver = true;
+        events.crashed = true;
+        return events;
+    }
+    // ---- brick-wall collision ----
+    events.hitWall = walls.contains(newX, newY);
+    if (events.hitWall) train.stripLastCarriage();
+    train.move(newX, newY);
+
+    if (newX == cargoX && newY == cargoY) {
+        events.pickedCargo = true;
+        train.addCarriage();
+        level++;
+        speed = fminf(speed + 0.5f, MAX_TICK_RATE);
+        spawnWalls();
+        placeCargo(); // ignore result
+    }
+    return events;
+}
+
+int GameSim::spawnWalls() {
+    if (level < 5) return 0;
+    int count = level - 4;
+
+    if (sparse) {
+        int spawned = 0, attempt = 0;
+        int wx, wy;
+        while (spawned < count && attempt < WALL_ATTEMPTS && randomFreeCell(wx, wy)) {
+            if (!connectivity.keepsConnected(walls, wx, wy, attempt >= WALL_ATTEMPTS / 2)) { attempt++; continue; }
+            walls.add(wx, wy);
+            spawned++;
+            attempt = 0;
+        }
+        return spawned;
+    }
+
+    // sample straight from the free cells; the cargo cell counts as free,
+    // so hide it for the duration
+    bool hideCargo = freeCells.isFree(cargoX, cargoY);
+    if (hideCargo) freeCells.occupy(cargoX, cargoY);
+
+    int spawned = 0;
+    while (spawned < count && freeCells.count() > 0) {
+        int wx, wy, attempt = 0;
+        do freeCells.cellAt(rng.below(freeCells.count()), wx, wy);
+        while (!connectivity.keepsConnected(walls, wx, wy, attempt >= WALL_ATTEMPTS / 2) && ++attempt < WALL_ATTEMPTS);
+        if (attempt == WALL_ATTEMPTS) break;    // every candidate would cut the board
+        walls.add(wx, wy);
+        freeCells.occupy(wx, wy);
+        spawned++;
+    }
+
+    if (hideCargo) freeCells.release(cargoX, cargoY);
+    return spawned;
+}
+
+bool GameSim::randomFreeCell(int& x, int& y) {
+    if (!sparse) {
+        bool hideCargo = cargoX >= 0 && freeCells.isFree(cargoX, cargoY);
+        if (hideCargo) freeCells.occupy(cargoX, cargoY);
+        bool found = ::placeCargo(x, y, freeCells, rng);
+        if (hideCargo) freeCells.release(cargoX, cargoY);
+        return found;
+    }
+
+    auto isFree = [&](int cx, int cy) {
+        return !train.isOnPosition(cx, cy) && !walls.contains(cx, cy) &&
+               !(cx == cargoX && cy == cargoY);
+    };
+    for (int probe = 0; probe < 64; probe++) {
+        x = rng.below(gridWidth);
+        y = rng.below(gridHeight);
+        if (isFree(x, y)) return true;
+    }
+    // only reached on a nearly full board: walk from a random cell
+    int64_t cells = (int64_t)gridWidth * gridHeight;
+    int64_t start = (int64_t)rng.below(gridHeight) * gridWidth + rng.below(gridWidth);
+    for (int64_t i = 0; i < cells; i++) {
+        int64_t cell = (start + i) % cells;
+        x = (int)(cell % gridWidth);
+        y = (int)(cell / gridWidth);
+        if (isFree(x, y)) return true;
+    }
+    return false;
+}
+
+bool GameSim::placeCargo() {
+    if (!sparse) return ::placeCargo(cargoX, cargoY, freeCells, rng);
+    int x, y;
+    if (!randomFreeCell(x, y)) return false;
+    cargoX = x;
+    cargoY = y;
+    return true;
+}
+
+static void mixHash(uint64_t& h, uint64_t v) {
+    h = (h ^ v) * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 32;
+}
+
+uint64_t GameSim::stateHash() const {
+    uint64_t h = 0x54524149ull;  // "TRAI"
+    mixHash(h, (uint64_t)gridWidth << 32 | (uint32_t)gridHeight);
+    mixHash(h, (uint64_t)(uint32_t)dirX << 32 | (uint32_t)dirY);
+    mixHash(h, (uint64_t)(uint32_t)cargoX << 32 | (uint32_t)cargoY);
+    mixHash(h, (uint64_t)(uint32_t)level << 32 | gameOver);
+    uint32_t speedBits;
+    std::memcpy(&speedBits, &speed, sizeof speedBits);
+    mixHash(h, speedBits);
+    mixHash(h, rng.state);
+    mixHash(h, train.length());
+    for (std::size_t i = 0; i < train.length(); i++)
+        mixHash(h, (uint64_t)(uint32_t)train[i].x << 32 | (uint32_t)train[i].y);
+    mixHash(h, walls.size());
+    for (const Wall& w : walls)
+        mixHash(h, (uint64_t)(uint32_t)w.x << 32 | (uint32_t)w.y);
+    return h;
+}
@@ -0,0 +1,69 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "train.h"
+#include "freecells.h"
+#include "connectivity.h"
+#include "rng.h"
+#include "walls.h"
+#include <cstdint>
+#include <vector>
+
+// Ticks per second the train speeds up to; the renderer interpolates, so
+// this is not bound to the display refresh rate.
+const float MAX_TICK_RATE = 12.0f;
+
+// Above this many cells the dense FreeCellSet (10 bytes a cell) is not kept;
+// huge worlds are nearly empty, so random probing finds a free cell at once.
+// Cell counts are 64-bit throughout: a 65535 x 65535 world overflows the
+// 32-bit long of the Windows build.
+const int64_t FREE_CELL_SET_LIMIT = (int64_t)1 << 22;
+
+// Requested heading for the next tick; {0, 0} keeps the current one.
+struct SimInput {
+    int dirX, dirY;
+};
+
+struct TickEvents {
+    bool crashed;      // ran into its own carriages, game is over
+    bool hitWall;      // drove through a wall and lost the last carriage
+    bool pickedCargo;
+};
+
+// Complete game rules without any raylib dependency. One step() is one
+// train tick; frame timing, input polling and drawing stay with the caller.
+class GameSim {
+public:
+    GameSim(int gridWidth, int gridHeight, uint64_t seed);
+    GameSim(const GameSim&) = delete;
+    GameSim& operator=(const GameSim&) = delete;
+
+    void reset(uint64_t seed);
+    TickEvents step(SimInput input);
+    // Places up to level - 4 walls on random free cells, skipping cells
+    // whose wall would cut the wall-free board apart; returns how many
+    // fitted, which is fewer once the board is full or closed in.
+    int spawnWalls();
+    // 64-bit digest of everything that influences future ticks.
+    uint64_t stateHash() const;
+    // Uniformly random cell without carriage, wall or cargo; false if none.
+    bool randomFreeCell(int& x, int& y);
+
+    int gridWidth, gridHeight;
+    bool sparse;                // huge world: no FreeCellSet, probe instead
+    FreeCellSet freeCells;
+    Train train;
+    WallSet walls;
+    int dirX, dirY;
+    int cargoX, cargoY;
+    int level;
+    float speed;
+    bool gameOver;
+    Rng rng;
+    ConnectivityCheck connectivity;    // where spawnWalls may put a wall
+
+private:
+    bool placeCargo();
+};
+
+#endif
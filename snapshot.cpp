@@ -0,0 +1,165 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <cstring>
+
+static const char SNAPSHOT_MAGIC[4] = { 'T', 'G', 'S', 'S' };
+static const std::size_t HASHED_FROM = offsetof(SnapshotHeader, hash) + sizeof(uint64_t);
+
+uint64_t hashSnapshot(const uint8_t* data, std::size_t size) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
+    }
+    for (; i < size; i++) h = (h ^ data[i]) * 0x94D049BB133111EBull;
+    return h ^ (h >> 29);
+}
+
+void takeSnapshot(std::vector<uint8_t>& out, const GameSim& sim, float timer, uint32_t tick) {
+    const Train& train = sim.train;
+    std::size_t length = train.length();
+    std::size_t freeCount = sim.sparse ? 0 : (std::size_t)sim.freeCells.count();
+    std::size_t size = sizeof(SnapshotHeader) + (length + sim.walls.size()) * 8 + freeCount * 4;
+    out.resize(size);
+
+    SnapshotHeader* h = reinterpret_cast<SnapshotHeader*>(out.data());
+    std::memcpy(h->magic, SNAPSHOT_MAGIC, 4);
+    h->version     = SNAPSHOT_VERSION;
+    h->size        = (uint32_t)size;
+    h->tick        = tick;
+    h->rngState    = sim.rng.state;
+    h->gridWidth   = sim.gridWidth;
+    h->gridHeight  = sim.gridHeight;
+    h->dirX        = sim.dirX;
+    h->dirY        = sim.dirY;
+    h->cargoX      = sim.cargoX;
+    h->cargoY      = sim.cargoY;
+    h->level       = sim.level;
+    h->gameOver    = sim.gameOver;
+    h->speed       = sim.speed;
+    h->timer       = timer;
+    h->vacatedX    = train.lastVacated().x;
+    h->vacatedY    = train.lastVacated().y;
+    h->trainLength = (uint32_t)length;
+    h->wallCount   = (uint32_t)sim.walls.size();
+    h->freeCellCount = (uint32_t)freeCount;
+    h->reserved    = 0;
+
+    TrainCarriage* carriages = reinterpret_cast<TrainCarriage*>(h + 1);
+    for (std::size_t i = 0; i < length; i++) carriages[i] = train[i];
+    if (!sim.walls.list().empty())
+        std::memcpy(carriages + length, sim.walls.list().data(), sim.walls.size() * sizeof(Wall));
+    if (freeCount)
+        std::memcpy(out.data() + size - freeCount * 4, sim.freeCells.order(), freeCount * 4);
+
+    h->hash = hashSnapshot(out.data() + HASHED_FROM, size - HASHED_FROM);
+}
+
+const SnapshotHeader* viewSnapshot(const uint8_t* data, std::size_t size) {
+    if (size < sizeof(SnapshotHeader)) return nullptr;
+    const SnapshotHeader* h = reinterpret_cast<const SnapshotHeader*>(data);
+    if (std::memcmp(h->magic, SNAPSHOT_MAGIC, 4) != 0 || h->version != SNAPSHOT_VERSION) return nullptr;
+    if (h->size != size || h->trainLength == 0 ||
+        size != sizeof(SnapshotHeader) + ((std::size_t)h->trainLength + h->wallCount) * 8 +
+                (std::size_t)h->freeCellCount * 4)
+        return nullptr;
+    if (h->hash != hashSnapshot(data + HASHED_FROM, size - HASHED_FROM)) return nullptr;
+    return h;
+}
+
+bool restoreSnapshot(GameSim& sim, const SnapshotHeader* s, std::vector<uint8_t>& board) {
+    if (s->gridWidth != sim.gridWidth || s->gridHeight != sim.gridHeight) return false;
+    auto onGrid = [&](int x, int y) { return x >= 0 && x < sim.gridWidth && y >= 0 && y < sim.gridHeight; };
+    const TrainCarriage* carriages = snapshotTrain(s);
+    const Wall* walls = snapshotWalls(s);
+    for (uint32_t i = 0; i < s->trainLength; i++)
+        if (!onGrid(carriages[i].x, carriages[i].y)) return false;
+    for (uint32_t i = 0; i < s->wallCount; i++)
+        if (!onGrid(walls[i].x, walls[i].y)) return false;
+    if (!onGrid(s->vacatedX, s->vacatedY)) return false;
+    if (s->freeCellCount != 0 && sim.sparse) return false;
+
+    // the free cells must be the complement of the train and walls; check
+    // that on a scratch board so a bad list leaves the sim as it was
+    if (!sim.sparse) {
+        board.assign((std::size_t)sim.gridWidth * sim.gridHeight, 0);
+        std::size_t taken = 0;
+        auto take = [&](int x, int y) {
+            uint8_t& cell = board[(std::size_t)y * sim.gridWidth + x];
+            if (!cell) { cell = 1; taken++; }
+        };
+        for (uint32_t i = 0; i < s->trainLength; i++) take(carriages[i].x, carriages[i].y);
+        for (uint32_t i = 0; i < s->wallCount; i++) take(walls[i].x, walls[i].y);
+        if (s->freeCellCount != board.size() - taken) return false;
+        const int32_t* freeCells = snapshotFreeCells(s);
+        for (uint32_t i = 0; i < s->freeCellCount; i++) {
+            if (freeCells[i] < 0 || (std::size_t)freeCells[i] >= board.size() || board[freeCells[i]]) return false;
+            board[freeCells[i]] = 2;    // a repeat now fails too
+        }
+    }
+
+    // walls hold a free-cell reference as well; swap them in after the train
+    for (const Wall& w : sim.walls)
+        if (!sim.sparse) sim.freeCells.release(w.x, w.y);
+    sim.walls.clear();
+    sim.train.assign(carriages, s->trainLength, { s->vacatedX, s->vacatedY });
+    for (uint32_t i = 0; i < s->wallCount; i++) {
+        if (sim.walls.add(walls[i].x, walls[i].y) && !sim.sparse)
+            sim.freeCells.occupy(walls[i].x, walls[i].y);
+    }
+    if (!sim.sparse) sim.freeCells.reorder(snapshotFreeCells(s), (int)s->freeCellCount);
+
+    sim.rng.state = s->rngState;
+    sim.dirX      = s->dirX;
+    sim.dirY      = s->dirY;
+    sim.cargoX    = s->cargoX;
+    sim.cargoY    = s->cargoY;
+    sim.level     = s->level;
+    sim.speed     = s->speed;
+    sim.gameOver  = s->gameOver != 0;
+    return true;
+}
+
+bool saveSnapshot(const std::vector<uint8_t>& blob, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(blob.data(), 1, blob.size(), f) == blob.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool loadSnapshot(std::vector<uint8_t>& blob, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    blob.clear();
+    uint8_t buffer[4096];
+    std::size_t n;
+    while ((n = fread(buffer, 1, sizeof buffer, f)) > 0) blob.insert(blob.end(), buffer, buffer + n);
+    fclose(f);
+    return viewSnapshot(blob.data(), blob.size()) != nullptr;
+}
+
+// ----------  REWIND RING  ----------
+void initSnapshotRing(SnapshotRing& ring, int capacity) {
+    ring.slots.assign(capacity, std::vector<uint8_t>());
+    ring.top   = capacity - 1;
+    ring.count = 0;
+}
+
+void pushSnapshot(SnapshotRing& ring, const GameSim& sim, float timer, uint32_t tick) {
+    int capacity = (int)ring.slots.size();
+    if (capacity == 0) return;
+    ring.top = (ring.top + 1) % capacity;
+    if (ring.count < capacity) ring.count++;
+    takeSnapshot(ring.slots[ring.top], sim, timer, tick);
+}
+
+const SnapshotHeader* popSnapshot(SnapshotRing& ring) {
+    if (ring.count == 0) return nullptr;
+    const std::vector<uint8_t>& blob = ring.slots[ring.top];
+    ring.top = (ring.top + (int)ring.slots.size() - 1) % (int)ring.slots.size();
+    ring.count--;
+    return reinterpret_cast<const SnapshotHeader*>(blob.data());
+}
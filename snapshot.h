@@ -0,0 +1,85 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "sim.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Complete game state as one flat blob with a fixed layout:
+//   SnapshotHeader | trainLength x TrainCarriage | wallCount x Wall |
+//   freeCellCount x int32 (y * width + x)
+// The free cells are stored in FreeCellSet order, because that order picks
+// the next cargo and wall cells; without it a restored game would play out
+// differently from the original. Huge (sparse) worlds have none.
+// Every field sits at a fixed, naturally aligned offset in host byte order
+// (little endian on all our targets), so a blob read or mapped from disk is
+// used in place: viewSnapshot() only checks it, and restoring copies the two
+// arrays straight into the GameSim.
+const uint32_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+    char     magic[4];                  // "TGSS"
+    uint32_t version;
+    uint32_t size;                      // whole blob, bytes
+    uint32_t tick;                      // caller's tick count (replay position)
+    uint64_t hash;                      // hashSnapshot() of everything after it
+    uint64_t rngState;
+    int32_t  gridWidth, gridHeight;
+    int32_t  dirX, dirY;
+    int32_t  cargoX, cargoY;
+    int32_t  level;
+    uint32_t gameOver;
+    float    speed;
+    float    timer;                     // caller's tick accumulator, seconds
+    int32_t  vacatedX, vacatedY;
+    uint32_t trainLength;
+    uint32_t wallCount;
+    uint32_t freeCellCount;
+    uint32_t reserved;                  // keeps the arrays 8-byte aligned
+};
+
+static_assert(sizeof(SnapshotHeader) == 96, "snapshot layout changed");
+static_assert(sizeof(TrainCarriage) == 8 && sizeof(Wall) == 8, "snapshot layout changed");
+
+// Overwrites `out` (keeping its capacity) with the state of `sim`.
+void takeSnapshot(std::vector<uint8_t>& out, const GameSim& sim, float timer, uint32_t tick);
+// The header in place if magic, version, size and hash check out.
+const SnapshotHeader* viewSnapshot(const uint8_t* data, std::size_t size);
+inline const TrainCarriage* snapshotTrain(const SnapshotHeader* s) {
+    return reinterpret_cast<const TrainCarriage*>(s + 1);
+}
+inline const Wall* snapshotWalls(const SnapshotHeader* s) {
+    return reinterpret_cast<const Wall*>(snapshotTrain(s) + s->trainLength);
+}
+inline const int32_t* snapshotFreeCells(const SnapshotHeader* s) {
+    return reinterpret_cast<const int32_t*>(snapshotWalls(s) + s->wallCount);
+}
+// Puts `sim` into the snapshot's state; false (sim untouched) if the grid
+// differs, a cell is off the grid or the free-cell list is not exactly the
+// cells left by the snapshot's train and walls. That is checked on
+// `scratch`, a byte per cell whose capacity is kept between calls.
+bool restoreSnapshot(GameSim& sim, const SnapshotHeader* snapshot, std::vector<uint8_t>& scratch);
+
+// 64-bit digest of a byte range, eight bytes per step.
+uint64_t hashSnapshot(const uint8_t* data, std::size_t size);
+
+bool saveSnapshot(const std::vector<uint8_t>& blob, const char* path);
+bool loadSnapshot(std::vector<uint8_t>& blob, const char* path);
+
+// The last `capacity` snapshots, newest on top. Slots keep their buffers,
+// so once the ring has wrapped, pushing no longer allocates. A ring of
+// capacity 0 keeps nothing.
+struct SnapshotRing {
+    std::vector<std::vector<uint8_t>> slots;
+    int top;                            // slot of the newest snapshot
+    int count;
+};
+
+void initSnapshotRing(SnapshotRing& ring, int capacity);
+void pushSnapshot(SnapshotRing& ring, const GameSim& sim, float timer, uint32_t tick);
+// Removes the newest snapshot and returns it (valid until the next push),
+// or nullptr when the ring is empty.
+const SnapshotHeader* popSnapshot(SnapshotRing& ring);
+
+#endif
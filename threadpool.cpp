@@ -0,0 +1,86 @@
+#include "threadpool.h"
+#include <algorithm>
+
+static uint64_t packRange(uint32_t begin, uint32_t end) { return begin | (uint64_t)end << 32; }
+
+WorkStealingPool::WorkStealingPool(int threads)
+    : generation(0), stopping(false), pending(0), body(nullptr), count(0), grain(1) {
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    queues.reset(new Queue[threads]);
+    for (int i = 0; i < threads; i++) queues[i].range.store(0);
+    // the caller is the last participant
+    for (int i = 0; i < threads - 1; i++) workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+bool WorkStealingPool::runChunk(int id) {
+    int n = size();
+    for (int k = 0; k < n; k++) {
+        int victim = (id + k) % n;
+        std::atomic<uint64_t>& range = queues[victim].range;
+        uint64_t r = range.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t begin = (uint32_t)r, end = (uint32_t)(r >> 32);
+            if (begin >= end) break;
+            // own queue from the front, someone else's from the back
+            uint32_t chunk = k == 0 ? begin : end - 1;
+            uint64_t next = k == 0 ? packRange(begin + 1, end) : packRange(begin, end - 1);
+            if (range.compare_exchange_weak(r, next, std::memory_order_acq_rel)) {
+                int first = (int)chunk * grain;
+                (*body)(first, std::min(first + grain, count));
+                pending.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int id) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        while (runChunk(id)) {}
+    }
+}
+
+void WorkStealingPool::parallelFor(int count, int grain, const std::function<void(int, int)>& body) {
+    if (count <= 0) return;
+    grain = std::max(grain, 1);
+    int chunks = (count + grain - 1) / grain;
+    int n = size();
+
+    this->body  = &body;
+    this->count = count;
+    this->grain = grain;
+    pending.store(chunks, std::memory_order_relaxed);
+    for (int i = 0; i < n; i++) {
+        uint32_t begin = (uint32_t)((int64_t)chunks * i / n);
+        uint32_t end   = (uint32_t)((int64_t)chunks * (i + 1) / n);
+        queues[i].range.store(packRange(begin, end), std::memory_order_release);
+    }
+
+    if (!workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            generation++;
+        }
+        wake.notify_all();
+    }
+
+    while (runChunk(n - 1)) {}
+    while (pending.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+}
@@ -0,0 +1,52 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. parallelFor() cuts
+// the index range into chunks and deals them out evenly; each thread eats
+// its own chunks from the front and, once out of work, steals from the back
+// of the others, so uneven chunks (resets, wall spawns) still balance out.
+// The calling thread takes part as well.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int threads = 0);   // 0: one per hardware thread
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const { return (int)workers.size() + 1; }
+    // Calls body(begin, end) over [0, count) in chunks of at most `grain`.
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& body);
+
+private:
+    // chunk range [begin, end) packed as begin | end << 32 so both ends can
+    // be claimed with one compare-and-swap
+    struct alignas(64) Queue {
+        std::atomic<uint64_t> range;
+    };
+
+    void workerLoop(int id);
+    bool runChunk(int id);
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Queue[]> queues;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint64_t generation;
+    bool stopping;
+
+    std::atomic<int> pending;
+    const std::function<void(int, int)>* body;
+    int count, grain;
+};
+
+#endif
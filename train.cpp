@@ -1,55 +1,109 @@
 #include "train.h"
+#include <utility>
 
-TrainCarriage::TrainCarriage(int x, int y) : x(x), y(y), next(nullptr) {}
-
-Train::Train(int startX, int startY) {
-    head = new TrainCarriage(startX, startY);
-    tail = head;
+Train::Train(int startX, int startY, int gridWidth, int gridHeight)
+    : ring(16), mask(15), first(0), count(1), vacated{ startX, startY },
+      cells(gridWidth, gridHeight), moves(0),
+      freeCells(nullptr) {
+    ring[0] = { startX, startY };
+    cells.add(startX, startY);
 }
 
-Train::~Train() {
-    TrainCarriage* current = head;
-    while (current) {
-        TrainCarriage* next = current->next;
-        delete current;
-        current = next;
+Train::Train(Train&& other) noexcept
+    : ring(std::move(other.ring)),
+      mask(std::exchange(other.mask, 0)),
+      first(std::exchange(other.first, 0)),
+      count(std::exchange(other.count, 0)),
+      vacated(other.vacated),
+      cells(std::move(other.cells)),
+      moves(std::exchange(other.moves, 0)),
+      freeCells(std::exchange(other.freeCells, nullptr)) {}
+
+Train& Train::operator=(Train&& other) noexcept {
+    if (this != &other) {
+        ring  = std::move(other.ring);
+        mask  = std::exchange(other.mask, 0);
+        first = std::exchange(other.first, 0);
+        count = std::exchange(other.count, 0);
+        vacated = other.vacated;
+        cells = std::move(other.cells);
+        moves = std::exchange(other.moves, 0);
+        freeCells = std::exchange(other.freeCells, nullptr);
     }
+    return *this;
 }
 
-void Train::addCarriage() {
-    TrainCarriage* newCarriage = new TrainCarriage(tail->x, tail->y);
-    tail->next = newCarriage;
-    tail = newCarriage;
+void Train::grow() {
+    std::vector<TrainCarriage> bigger(ring.size() * 2);
+    for (std::size_t i = 0; i < count; i++)
+        bigger[i] = (*this)[i];
+    ring  = std::move(bigger);
+    mask  = ring.size() - 1;
+    first = 0;
 }
 
-void Train::move(int newX, int newY) {
-    int prevX = head->x;
-    int prevY = head->y;
+void Train::trackFreeCells(FreeCellSet* set) {
+    freeCells = set;
+    if (!freeCells) return;
+    for (std::size_t i = 0; i < count; i++)
+        freeCells->occupy((*this)[i].x, (*this)[i].y);
+}
 
-    head->x = newX;
-    head->y = newY;
+void Train::addCarriage() {
+    if (count == ring.size()) grow();
+    TrainCarriage last = tail();
+    ring[(first + count) & mask] = last;
+    cells.add(last.x, last.y);
+    if (freeCells) freeCells->occupy(last.x, last.y);
+    count++;
+}
 
-    TrainCarriage* current = head->next;
-    while (current) {
-        int tempX = current->x;
-        int tempY = current->y;
+void Train::stripLastCarriage() {
+    if (count <= 1) return;
+    const TrainCarriage& last = tail();
+    cells.remove(last.x, last.y);
+    if (freeCells) freeCells->release(last.x, last.y);
+    count--;
+}
+
+void Train::move(int newX, int newY) {
+    const TrainCarriage& last = tail();
+    vacated = last;
+    // enter before leaving, so a chunk is not released and re-taken when
+    // the head and tail share it
+    cells.enter(newX, newY, ++moves);
+    cells.remove(last.x, last.y);
+    if (freeCells) {
+        freeCells->release(last.x, last.y);
+        freeCells->occupy(newX, newY);
+    }
+    first = (first - 1) & mask;
+    ring[first] = { newX, newY };
+}
 
-        current->x = prevX;
-        current->y = prevY;
+void Train::assign(const TrainCarriage* carriages, std::size_t length, const TrainCarriage& lastVacated) {
+    if (freeCells)
+        for (std::size_t i = 0; i < count; i++) freeCells->release((*this)[i].x, (*this)[i].y);
 
-        prevX = tempX;
-        prevY = tempY;
+    std::size_t size = ring.size();
+    while (size < length) size *= 2;
+    if (size != ring.size()) ring.resize(size);
+    mask  = size - 1;
+    first = 0;
+    count = length;
+    vacated = lastVacated;
 
-        current = current->next;
+    // replay the stamps the moves would have left: carriage i came in
+    // length - 1 - i moves ago, and on a shared cell the front one counts
+    cells.clear();
+    moves = (uint32_t)(length - 1);
+    for (std::size_t i = length; i-- > 0;) {
+        ring[i] = carriages[i];
+        cells.enter(carriages[i].x, carriages[i].y, (uint32_t)(length - 1 - i));
+        if (freeCells) freeCells->occupy(carriages[i].x, carriages[i].y);
     }
 }
 
 bool Train::isOnPosition(int x, int y) const {
-    TrainCarriage* current = head;
-    while (current) {
-        if (current->x == x && current->y == y)
-            return true;
-        current = current->next;
-    }
-    return false;
+    return cells.isOccupied(x, y);
 }
@@ -1,26 +1,68 @@
 #ifndef TRAIN_H
 #define TRAIN_H
 
-class TrainCarriage {
-public:
-    int x, y;
-    TrainCarriage* next;
+#include "freecells.h"
+#include "occupancy.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
-    TrainCarriage(int x, int y);
+struct TrainCarriage {
+    int x, y;
 };
 
+// Carriage positions live in a power-of-two ring buffer. The locomotive is
+// at `first`, carriage i at (first + i) & mask, so advancing the train only
+// writes the new head into the slot in front of it (the old tail slot when
+// the buffer is full) and dropping the tail is a length decrement.
+// Every carriage is also counted in an occupancy grid, so position queries
+// are a single lookup however long the train gets. A train can also be
+// attached to the world's FreeCellSet, which it then keeps up to date.
+// The grid also stamps each cell with the move on which the head entered
+// it; since every move shifts all carriages back one index, moves - stamp
+// is the index of the carriage on that cell, which lets a renderer walk
+// only the cells on screen instead of the whole train.
 class Train {
 public:
-    TrainCarriage* head;
-    TrainCarriage* tail;
-
-    Train(int startX, int startY);
-    ~Train();
+    Train(int startX, int startY, int gridWidth, int gridHeight);
+    // No copies: a copy would keep updating the original's FreeCellSet.
+    Train(const Train& other) = delete;
+    Train(Train&& other) noexcept;
+    Train& operator=(const Train& other) = delete;
+    Train& operator=(Train&& other) noexcept;
 
+    void trackFreeCells(FreeCellSet* freeCells);
     void addCarriage();
+    void stripLastCarriage();
     void move(int newX, int newY);
+    // Replaces the whole train (locomotive first), keeping buffer capacity;
+    // `vacated` becomes lastVacated().
+    void assign(const TrainCarriage* carriages, std::size_t length, const TrainCarriage& vacated);
     bool isOnPosition(int x, int y) const;
+    // index of the carriage on an occupied cell (the older one, if a fresh
+    // carriage shares it)
+    std::size_t carriageAt(int x, int y) const { return moves - cells.enteredAt(x, y); }
+
+    const TrainCarriage& head() const { return ring[first]; }
+    const TrainCarriage& tail() const { return ring[(first + count - 1) & mask]; }
+    const TrainCarriage& operator[](std::size_t i) const { return ring[(first + i) & mask]; }
+    std::size_t length() const { return count; }
+    // Cell the last move() dropped off the tail; with carriage i+1 it gives
+    // every carriage's position one tick ago, for render interpolation.
+    const TrainCarriage& lastVacated() const { return vacated; }
+    const OccupancyGrid& occupancy() const { return cells; }
+
+private:
+    void grow();
+
+    std::vector<TrainCarriage> ring;
+    std::size_t mask;
+    std::size_t first;
+    std::size_t count;
+    TrainCarriage vacated;
+    OccupancyGrid cells;
+    uint32_t moves;
+    FreeCellSet* freeCells;
 };
-bool placeCargo(int& cargoX, int& cargoY, Train& train, int gridWidth, int gridHeight);
 
 #endif
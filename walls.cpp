@@ -0,0 +1,18 @@
+#include "walls.h"
+
+WallSet::WallSet(int width, int height)
+    : width(width), height(height), cells(width, height), clears(0) {}
+
+bool WallSet::add(int x, int y) {
+    uint8_t& cell = cells.at(x, y);
+    if (cell) return false;
+    cell = 1;
+    walls.push_back({ x, y });
+    return true;
+}
+
+void WallSet::clear() {
+    for (const Wall& w : walls) cells.at(w.x, w.y) = 0;
+    walls.clear();
+    clears++;
+}
@@ -0,0 +1,41 @@
+#ifndef WALLS_H
+#define WALLS_H
+
+#include "chunkgrid.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Wall {
+    int x, y;
+};
+
+// Walls in spawn order plus a per-cell flag, so hit tests are one lookup
+// and iteration (drawing, syncing) stays a plain vector walk. The flags are
+// chunked like the occupancy grid, so huge worlds can be culled per chunk.
+class WallSet {
+public:
+    WallSet(int width, int height);
+
+    bool add(int x, int y);             // false if the cell already has a wall
+    bool contains(int x, int y) const { return cells.get(x, y) != 0; }
+    bool chunkEmpty(int cx, int cy) const { return cells.chunkEmpty(cx, cy); }
+    void clear();
+    // Bumped by clear(); walls only ever get added between two clears, so
+    // an unchanged generation means the list only grew.
+    uint32_t generation() const { return clears; }
+
+    std::size_t size() const { return walls.size(); }
+    const std::vector<Wall>& list() const { return walls; }
+    std::vector<Wall>::const_iterator begin() const { return walls.begin(); }
+    std::vector<Wall>::const_iterator end() const { return walls.end(); }
+
+    int width, height;
+
+private:
+    std::vector<Wall> walls;
+    ChunkedGrid<uint8_t> cells;
+    uint32_t clears;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "worldview.h"
+#include "graphics.h"
+#include "profiler.h"
+#include "scene.h"
+#include <algorithm>
+#include <cmath>
+
+WorldView loadWorldView(int worldWidth, int worldHeight, int cellSize) {
+    WorldView view;
+    view.camera = (Camera2D){ {0, 0}, {0, 0}, 0.0f, 1.0f };
+    view.cellSize = cellSize;
+    view.worldWidth  = worldWidth;
+    view.worldHeight = worldHeight;
+    view.x0 = view.y0 = view.x1 = view.y1 = 0;
+    view.locomotive = (Vector2){ 0, 0 };
+
+    // the middle cell of a 3x3 track grid, so both rails and ties are cut
+    // exactly at the cell edges and the tile repeats seamlessly
+    view.trackTile = LoadRenderTexture(cellSize, cellSize);
+    SetTextureWrap(view.trackTile.texture, TEXTURE_WRAP_REPEAT);
+    BeginTextureMode(view.trackTile);
+    ClearBackground(BLANK);
+    BeginMode2D((Camera2D){ {0, 0}, {(float)cellSize, (float)cellSize}, 0.0f, 1.0f });
+    drawTrainTracks(3, 3, cellSize, 0);
+    EndMode2D();
+    EndTextureMode();
+    return view;
+}
+
+void unloadWorldView(WorldView& view) {
+    UnloadRenderTexture(view.trackTile);
+    view.trackTile = {};
+}
+
+static int wrapCell(int v, int extent) {
+    v %= extent;
+    return v < 0 ? v + extent : v;
+}
+
+// Cell coordinate `alpha` of the way from `from` to `to`; unlike the fixed
+// board, a step across the seam slides too, starting just outside the
+// world on the side it wrapped to.
+static float lerpWrapped(int from, int to, float alpha, int extent) {
+    int step = to - from;
+    if (step > 1) step -= extent;
+    else if (step < -1) step += extent;
+    return to - step * (1.0f - alpha);
+}
+
+// Interpolated position of carriage `index` in cells, within one cell of
+// its current cell.
+static Vector2 carriageCell(const WorldView& view, const Train& train, std::size_t index, float alpha) {
+    const TrainCarriage& current = train[index];
+    const TrainCarriage& previous = previousCell(train, index);
+    return (Vector2){ lerpWrapped(previous.x, current.x, alpha, view.worldWidth),
+                      lerpWrapped(previous.y, current.y, alpha, view.worldHeight) };
+}
+
+void followTrain(WorldView& view, const Train& train, float alpha, int screenWidth, int screenHeight, Vector2 shake) {
+    int cs = view.cellSize;
+    Vector2 cell = carriageCell(view, train, 0, alpha);
+    view.locomotive = (Vector2){ floorf(cell.x * cs), floorf(cell.y * cs) };
+
+    float halfW = screenWidth * 0.5f, halfH = screenHeight * 0.5f;
+    float cx = view.locomotive.x + cs * 0.5f;
+    float cy = view.locomotive.y + cs * 0.5f;
+    view.camera = (Camera2D){ {halfW + shake.x, halfH + shake.y}, {cx, cy}, 0.0f, 1.0f };
+
+    // one cell of slack on each side: carriages slide in from the next cell
+    // and sprites overhang theirs by the atlas padding
+    view.x0 = (int)floorf((cx - halfW) / cs) - 1;
+    view.y0 = (int)floorf((cy - halfH) / cs) - 1;
+    view.x1 = (int)ceilf((cx + halfW) / cs) + 1;
+    view.y1 = (int)ceilf((cy + halfH) / cs) + 1;
+}
+
+// Calls visit(sx, sy) for every on-screen copy of world cell (gx, gy);
+// worlds smaller than the screen show a cell more than once.
+template <typename Visit>
+static void visitCopies(const WorldView& view, int gx, int gy, Visit visit) {
+    for (int sy = view.y0 + wrapCell(gy - view.y0, view.worldHeight); sy < view.y1; sy += view.worldHeight)
+        for (int sx = view.x0 + wrapCell(gx - view.x0, view.worldWidth); sx < view.x1; sx += view.worldWidth)
+            visit(sx, sy);
+}
+
+// Calls visit(gx, gy, sx, sy) for every visible cell whose chunk has ever
+// been written to in `grid`: (gx, gy) is the world cell, (sx, sy) the copy
+// of it on screen. The visible range is cut at the seams into pieces that
+// each map onto one block of world cells.
+template <typename Grid, typename Visit>
+static void visitCells(const WorldView& view, const Grid& grid, Visit visit) {
+    const int bits = ChunkedGrid<uint8_t>::CHUNK_BITS;
+
+    for (int sy0 = view.y0; sy0 < view.y1; ) {
+        int wy0 = wrapCell(sy0, view.worldHeight);
+        int wy1 = std::min(view.worldHeight, wy0 + (view.y1 - sy0));
+        for (int sx0 = view.x0; sx0 < view.x1; ) {
+            int wx0 = wrapCell(sx0, view.worldWidth);
+            int wx1 = std::min(view.worldWidth, wx0 + (view.x1 - sx0));
+            int dx = sx0 - wx0, dy = sy0 - wy0;
+
+            for (int cy = wy0 >> bits; cy <= (wy1 - 1) >> bits; cy++) {
+                for (int cx = wx0 >> bits; cx <= (wx1 - 1) >> bits; cx++) {
+                    if (grid.chunkEmpty(cx, cy)) continue;
+                    int gx0 = std::max(wx0, cx << bits), gx1 = std::min(wx1, (cx + 1) << bits);
+                    int gy0 = std::max(wy0, cy << bits), gy1 = std::min(wy1, (cy + 1) << bits);
+                    for (int gy = gy0; gy < gy1; gy++)
+                        for (int gx = gx0; gx < gx1; gx++)
+                            visit(gx, gy, gx + dx, gy + dy);
+                }
+            }
+            sx0 += wx1 - wx0;
+        }
+        sy0 += wy1 - wy0;
+    }
+}
+
+void drawWorldTracks(const WorldView& view) {
+    float cs = (float)view.cellSize;
+    // the repeat wrap mode tiles the single cell over the visible range
+    Rectangle source = { view.x0 * cs, view.y0 * cs, (view.x1 - view.x0) * cs, -(view.y1 - view.y0) * cs };
+    Rectangle dest = { view.x0 * cs, view.y0 * cs, source.width, -source.height };
+    queueTexture(LAYER_GROUND, view.trackTile.texture, source, dest, WHITE);
+    profileDraws(1);
+}
+
+void drawWorldWalls(const WorldView& view, const SpriteAtlas& atlas, const WallSet& walls) {
+    int cs = view.cellSize;
+    visitCells(view, walls, [&](int gx, int gy, int sx, int sy) {
+        if (walls.contains(gx, gy)) drawSprite(atlas, SPRITE_WALL, sx * cs, sy * cs, LAYER_GROUND);
+    });
+}
+
+void drawWorldCargo(const WorldView& view, const SpriteAtlas& atlas, int cargoX, int cargoY) {
+    int cs = view.cellSize;
+    visitCopies(view, cargoX, cargoY, [&](int sx, int sy) {
+        drawSprite(atlas, SPRITE_CARGO, sx * cs, sy * cs);
+    });
+}
+
+void drawWorldTrain(const WorldView& view, const SpriteAtlas& atlas, const Train& train, int dirX, int dirY,
+                    float alpha, float time) {
+    int cs = view.cellSize;
+    int wheelFrame = wheelFrameAt(time * 12.0f);
+    const TrainCarriage& head = train.head();
+    Vector2 headCell = carriageCell(view, train, 0, alpha);
+    visitCopies(view, head.x, head.y, [&](int sx, int sy) {
+        drawSprite(atlas, locomotiveSprite(dirX, dirY), (int)floorf((headCell.x + sx - head.x) * cs),
+                   (int)floorf((headCell.y + sy - head.y) * cs));
+    });
+
+    visitCells(view, train.occupancy(), [&](int gx, int gy, int sx, int sy) {
+        if (!train.isOnPosition(gx, gy)) return;
+        std::size_t index = train.carriageAt(gx, gy);
+        if (index == 0) return;
+        Vector2 cell = carriageCell(view, train, index, alpha);
+        drawSprite(atlas, SPRITE_CARRIAGE + wheelFrame, (int)floorf((cell.x + sx - gx) * cs),
+                   (int)floorf((cell.y + sy - gy) * cs));
+    });
+}
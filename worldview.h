@@ -0,0 +1,38 @@
+#pragma once
+#include "raylib.h"
+#include "atlas.h"
+#include "train.h"
+#include "walls.h"
+
+// Worlds larger than the screen cannot be baked into a Playfield texture, so
+// they are drawn straight from the simulation under a camera that follows
+// the locomotive. Only the visible cell range is walked, and chunks with
+// nothing in them are skipped, so frame cost depends on the viewport rather
+// than on the world size or the train length.
+// The world is a torus, so the visible range is not clamped: it runs past
+// the edges, and cells beyond them are drawn as copies of the cells on the
+// other side of the seam.
+struct WorldView {
+    Camera2D camera;
+    int cellSize;
+    int worldWidth, worldHeight;        // in cells
+    int x0, y0, x1, y1;                 // visible cells, half open, unwrapped
+    Vector2 locomotive;                 // where the locomotive is drawn
+    RenderTexture2D trackTile;          // one cell of track, drawn repeated
+};
+
+WorldView loadWorldView(int worldWidth, int worldHeight, int cellSize);
+void unloadWorldView(WorldView& view);
+
+// Centres the camera on the interpolated locomotive and works out which
+// cells are on screen. When the locomotive crosses the seam the camera
+// jumps by a whole world, which shows the same picture.
+void followTrain(WorldView& view, const Train& train, float alpha, int screenWidth, int screenHeight, Vector2 shake);
+
+// These record into renderList; submit it between BeginMode2D(view.camera)
+// and EndMode2D.
+void drawWorldTracks(const WorldView& view);
+void drawWorldWalls(const WorldView& view, const SpriteAtlas& atlas, const WallSet& walls);
+void drawWorldCargo(const WorldView& view, const SpriteAtlas& atlas, int cargoX, int cargoY);
+void drawWorldTrain(const WorldView& view, const SpriteAtlas& atlas, const Train& train, int dirX, int dirY,
+                    float alpha, float time);